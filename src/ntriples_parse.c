@@ -52,6 +52,12 @@
 */
 
 
+/* These are for 7-bit ASCII and not locale-specific */
+#define IS_ASCII_ALPHA(c) (((c) > 0x40 && (c) < 0x5B) || ((c) > 0x60 && (c) < 0x7B))
+#define IS_ASCII_DIGIT(c) ((c) > 0x2F && (c) < 0x3A)
+
+typedef struct raptor_ntriples_batch_s raptor_ntriples_batch;
+
 /* Prototypes for local functions */
 static void raptor_ntriples_generate_statement(raptor_parser* parser, raptor_term* subject_term, raptor_term* predicate_term, raptor_term* object_term, raptor_term* graph_term);
 
@@ -59,13 +65,26 @@ static void raptor_ntriples_generate_statement(raptor_parser* parser, raptor_ter
  * NTriples parser object
  */
 struct raptor_ntriples_parser_context_s {
-  /* current line */
+  /* input window: unconsumed bytes from previous chunks plus the
+   * current chunk.  Allocated once and grown by doubling; consumed
+   * lines are dropped by sliding the unconsumed tail to the start.
+   */
   unsigned char *line;
-  /* current line length */
+  /* bytes of data in the window */
   size_t line_length;
-  /* current char in line buffer */
+  /* allocated size of the window (not including the NUL) */
+  size_t line_size;
+  /* start of the unconsumed data in the window */
   size_t offset;
 
+  /* bytes of the partial line at offset already scanned for a line
+   * end and the scanner state after them, so that a long line split
+   * across many chunks is only scanned once */
+  size_t scan_length;
+  int scan_quote;
+  int scan_in_uri;
+  int scan_bq;
+
   char last_char;
   
   /* static statement for use in passing to user code */
@@ -75,11 +94,25 @@ struct raptor_ntriples_parser_context_s {
   int is_nquads;
 
   int literal_graph_warning;
+
+  /* bytes that can end a line or change the line scanner state */
+  raptor_scan_set delimiters;
+
+  /* parallel parsing: worker threads or NULL when parsing serially */
+  raptor_workers* workers;
+  /* batch of lines being filled */
+  raptor_ntriples_batch* batch;
+  /* emitted batches kept for reuse */
+  raptor_ntriples_batch* free_batches;
+  /* locator of the line splitting, which runs ahead of the statements */
+  raptor_locator split_locator;
 };
 
 
 typedef struct raptor_ntriples_parser_context_s raptor_ntriples_parser_context;
 
+static void raptor_ntriples_free_workers(raptor_ntriples_parser_context* ntriples_parser);
+
 
 
 /**
@@ -100,6 +133,10 @@ raptor_ntriples_parse_init(raptor_parser* rdf_parser, const char *name)
 
   if(!strcmp(name, "nquads"))
     ntriples_parser->is_nquads = 1;
+
+  if(raptor_scan_set_init(&ntriples_parser->delimiters,
+                          (const unsigned char*)"\n\r\"'<>\\", 7))
+    return 1;
   
   return 0;
 }
@@ -118,8 +155,10 @@ raptor_ntriples_parse_terminate(raptor_parser* rdf_parser)
 {
   raptor_ntriples_parser_context *ntriples_parser;
   ntriples_parser = (raptor_ntriples_parser_context*)rdf_parser->context;
-  if(ntriples_parser->line_length)
+  if(ntriples_parser->line)
     RAPTOR_FREE(cdata, ntriples_parser->line);
+
+  raptor_ntriples_free_workers(ntriples_parser);
 }
 
 
@@ -148,14 +187,18 @@ raptor_ntriples_generate_statement(raptor_parser* parser,
     goto cleanup;
 
   /* If there is no statement handler - there is nothing else to do */
-  if(!parser->statement_handler)
+  if(!RAPTOR_PARSER_HAS_STATEMENT_HANDLER(parser))
     goto cleanup;
 
   /* Generate the statement */
-  (*parser->statement_handler)(parser->user_data, statement);
+  raptor_parser_emit_statement(parser, statement);
 
   cleanup:
   raptor_free_statement(statement);
+
+  /* the terms were either freed or allocated from the arena */
+  if(parser->arena)
+    raptor_arena_reset(parser->arena);
 }
 
 
@@ -257,7 +300,9 @@ raptor_ntriples_parse_line(raptor_parser* rdf_parser,
     }
 
 
-    term_len = raptor_ntriples_parse_term(rdf_parser->world, &rdf_parser->locator,
+    term_len = raptor_ntriples_parse_term(rdf_parser->world,
+                                          rdf_parser->arena,
+                                          &rdf_parser->locator,
                                           p, &len, &terms[i], 0);
     if(!term_len) {
       rc = 1;
@@ -373,10 +418,944 @@ raptor_ntriples_parse_line(raptor_parser* rdf_parser,
       raptor_free_term(terms[i]);
   }
 
+  if(rdf_parser->arena)
+    raptor_arena_reset(rdf_parser->arena);
+
   return rc;
 }
 
 
+/*
+ * Parallel parsing
+ *
+ * With RAPTOR_OPTION_PARSE_THREADS > 1 the chunk parser still finds
+ * the line boundaries but, rather than parsing each line, copies
+ * complete lines into a batch.  Full batches are decoded on a worker
+ * thread into the term strings (escapes expanded, IRIs checked) with
+ * no use of the raptor_world.  The parser thread then collects the
+ * decoded batches, in document order or as they finish, builds the
+ * terms and returns the statements.
+ *
+ * Workers only decode the common forms.  Anything else - errors,
+ * warnings and rarely used escapes - is marked for the parser thread
+ * to parse serially with raptor_ntriples_parse_line() so errors are
+ * reported exactly as before.  Blank node labels are turned into
+ * terms on the parser thread exactly as in serial parsing so their
+ * scope is unchanged.
+ */
+
+/* Size of input lines in a batch before it is handed to a worker */
+#define RAPTOR_NTRIPLES_BATCH_SIZE (128 * 1024)
+
+/* Batches that may be outstanding per worker thread */
+#define RAPTOR_NTRIPLES_BATCHES_PER_THREAD 2
+
+typedef enum {
+  RAPTOR_NTRIPLES_LINE_SKIP,    /* blank or comment line */
+  RAPTOR_NTRIPLES_LINE_DECODED, /* terms decoded */
+  RAPTOR_NTRIPLES_LINE_SERIAL   /* parse on the parser thread */
+} raptor_ntriples_line_status;
+
+typedef struct {
+  raptor_term_type type;
+  /* offsets into the batch output of NUL terminated strings */
+  size_t value;
+  size_t value_len;
+  size_t language;
+  size_t language_len;
+  size_t datatype;
+  size_t datatype_len;
+} raptor_ntriples_decoded_term;
+
+typedef struct {
+  /* offset of the NUL terminated line in the batch input */
+  size_t offset;
+  size_t length;
+  /* locator at the line start */
+  int line;
+  int byte;
+
+  raptor_ntriples_line_status status;
+  int terms_count;
+  raptor_ntriples_decoded_term terms[MAX_NTRIPLES_TERMS];
+} raptor_ntriples_batch_line;
+
+struct raptor_ntriples_batch_s {
+  struct raptor_ntriples_batch_s* next;
+
+  int is_nquads;
+
+  unsigned char* input;
+  size_t input_length;
+  size_t input_size;
+
+  /* decoded strings; never longer than the input */
+  unsigned char* output;
+  size_t output_size;
+
+  raptor_ntriples_batch_line* lines;
+  int lines_count;
+  int lines_size;
+};
+
+
+static void
+raptor_free_ntriples_batch(raptor_ntriples_batch* batch)
+{
+  if(batch->input)
+    RAPTOR_FREE(char*, batch->input);
+  if(batch->output)
+    RAPTOR_FREE(char*, batch->output);
+  if(batch->lines)
+    RAPTOR_FREE(raptor_ntriples_batch_line*, batch->lines);
+  RAPTOR_FREE(raptor_ntriples_batch, batch);
+}
+
+
+/*
+ * raptor_ntriples_decode_iri:
+ * @p_p: pointer to input pointer after the < (in/out)
+ * @len_p: pointer to input length (in/out)
+ * @out_p: pointer to output pointer (in/out)
+ * @value_p: pointer to store offset of the IRI in @output (out)
+ * @value_len_p: pointer to store length of the IRI (out)
+ * @output: start of the batch output
+ *
+ * INTERNAL - Decode an IRI with no escapes up to and past the >
+ *
+ * Runs on a worker thread.
+ *
+ * Return value: non-0 if the IRI must be parsed serially
+ */
+static int
+raptor_ntriples_decode_iri(const unsigned char** p_p, size_t* len_p,
+                           unsigned char** out_p,
+                           size_t* value_p, size_t* value_len_p,
+                           unsigned char* output)
+{
+  const unsigned char* p = *p_p;
+  size_t len = *len_p;
+  unsigned char* out = *out_p;
+  unsigned char* start = out;
+
+  while(1) {
+    unsigned char c;
+
+    if(!len)
+      return 1;
+
+    c = *p;
+    if(c == '>')
+      break;
+
+    if(c > 0x7f) {
+      int unichar_len = raptor_unicode_utf8_string_get_char(p, len, NULL);
+      if(unichar_len < 0 || RAPTOR_GOOD_CAST(size_t, unichar_len) > len - 1)
+        return 1;
+      memcpy(out, p, unichar_len);
+      out += unichar_len;
+      p += unichar_len;
+      len -= unichar_len;
+      continue;
+    }
+
+    if(c <= 0x20 || c == '<' || c == '"' || c == '{' || c == '}' ||
+       c == '|' || c == '^' || c == '`' || c == '\\')
+      return 1;
+
+    *out++ = c;
+    p++;
+    len--;
+  }
+  /* skip > */
+  p++;
+  len--;
+  *out = '\0';
+
+  if(raptor_uri_uri_string_is_absolute(start) <= 0)
+    return 1;
+
+  /* ordinal predicates are checked and reported by the serial parser */
+  if(!strncmp((const char*)start,
+              "http://www.w3.org/1999/02/22-rdf-syntax-ns#_", 44))
+    return 1;
+
+  *value_p = RAPTOR_GOOD_CAST(size_t, start - output);
+  *value_len_p = RAPTOR_GOOD_CAST(size_t, out - start);
+
+  *p_p = p;
+  *len_p = len;
+  *out_p = out + 1;
+
+  return 0;
+}
+
+
+/*
+ * raptor_ntriples_decode_term:
+ * @p_p: pointer to input pointer (in/out)
+ * @len_p: pointer to input length (in/out)
+ * @out_p: pointer to output pointer (in/out)
+ * @term: decoded term (out)
+ * @output: start of the batch output
+ *
+ * INTERNAL - Decode one term the same way raptor_ntriples_parse_term() does
+ *
+ * Runs on a worker thread.
+ *
+ * Return value: non-0 if the term must be parsed serially
+ */
+static int
+raptor_ntriples_decode_term(const unsigned char** p_p, size_t* len_p,
+                            unsigned char** out_p,
+                            raptor_ntriples_decoded_term* term,
+                            unsigned char* output)
+{
+  const unsigned char* p = *p_p;
+  size_t len = *len_p;
+  unsigned char* out = *out_p;
+  unsigned char* start;
+  int position = 0;
+
+  memset(term, '\0', sizeof(*term));
+
+  switch(*p) {
+    case '<':
+      p++;
+      len--;
+      if(raptor_ntriples_decode_iri(&p, &len, &out,
+                                    &term->value, &term->value_len, output))
+        return 1;
+      term->type = RAPTOR_TERM_TYPE_URI;
+      break;
+
+    case '_':
+      p++;
+      len--;
+      if(!len || *p != ':')
+        return 1;
+      p++;
+      len--;
+
+      start = out;
+      while(len) {
+        unsigned char c = *p;
+        int valid;
+
+        if(c > 0x7f) {
+          /* UTF-8 is copied through and does not count as a position */
+          int unichar_len = raptor_unicode_utf8_string_get_char(p, len, NULL);
+          if(unichar_len < 0 || RAPTOR_GOOD_CAST(size_t, unichar_len) > len - 1)
+            return 1;
+          memcpy(out, p, unichar_len);
+          out += unichar_len;
+          p += unichar_len;
+          len -= unichar_len;
+          continue;
+        }
+
+        if(c == '\\')
+          return 1;
+
+        valid = IS_ASCII_ALPHA(c) || IS_ASCII_DIGIT(c) || c == '_' || c == ':';
+        if(position)
+          valid = (valid || c == '-' || c == '.');
+        if(!valid) {
+          /* a bnode ID ended by another character cannot end in '.' */
+          if(out > start && out[-1] == '.') {
+            out--;
+            p--;
+            len++;
+          }
+          break;
+        }
+
+        *out++ = c;
+        position++;
+        p++;
+        len--;
+      }
+
+      if(out == start)
+        return 1;
+      *out = '\0';
+
+      term->type = RAPTOR_TERM_TYPE_BLANK;
+      term->value = RAPTOR_GOOD_CAST(size_t, start - output);
+      term->value_len = RAPTOR_GOOD_CAST(size_t, out - start);
+      out++;
+      break;
+
+    case '"':
+      p++;
+      len--;
+
+      start = out;
+      while(1) {
+        unsigned char c;
+
+        if(!len)
+          return 1;
+
+        c = *p;
+        if(c == '"')
+          break;
+
+        if(c > 0x7f) {
+          int unichar_len = raptor_unicode_utf8_string_get_char(p, len, NULL);
+          if(unichar_len < 0 || RAPTOR_GOOD_CAST(size_t, unichar_len) > len - 1)
+            return 1;
+          memcpy(out, p, unichar_len);
+          out += unichar_len;
+          p += unichar_len;
+          len -= unichar_len;
+          continue;
+        }
+
+        p++;
+        len--;
+        if(c != '\\') {
+          *out++ = c;
+          continue;
+        }
+
+        if(!len)
+          return 1;
+        c = *p++;
+        len--;
+
+        switch(c) {
+          case '"':
+          case '\'':
+          case '\\':
+            *out++ = c;
+            break;
+          case 'b':
+            *out++ = '\b';
+            break;
+          case 'f':
+            *out++ = '\f';
+            break;
+          case 'n':
+            *out++ = '\n';
+            break;
+          case 'r':
+            *out++ = '\r';
+            break;
+          case 't':
+            *out++ = '\t';
+            break;
+
+          case 'u':
+          case 'U':
+            if(1) {
+              size_t ulen = (c == 'u') ? 4 : 8;
+              raptor_unichar unichar = 0;
+              size_t ii;
+              int unichar_width;
+
+              if(len < ulen)
+                return 1;
+
+              for(ii = 0; ii < ulen; ii++) {
+                int digit = p[ii];
+                if(IS_ASCII_DIGIT(digit))
+                  digit -= '0';
+                else if(digit >= 'a' && digit <= 'f')
+                  digit -= 'a' - 10;
+                else if(digit >= 'A' && digit <= 'F')
+                  digit -= 'A' - 10;
+                else
+                  return 1;
+                unichar = (unichar << 4) | RAPTOR_GOOD_CAST(raptor_unichar, digit);
+              }
+              p += ulen;
+              len -= ulen;
+
+              /* a NUL would truncate the serial parser's literal */
+              if(!unichar || unichar > raptor_unicode_max_codepoint)
+                return 1;
+
+              unichar_width = raptor_unicode_utf8_string_put_char(unichar, out, 4);
+              if(unichar_width < 0)
+                return 1;
+              out += unichar_width;
+            }
+            break;
+
+          default:
+            return 1;
+        }
+      }
+      /* skip " */
+      p++;
+      len--;
+      *out = '\0';
+
+      term->type = RAPTOR_TERM_TYPE_LITERAL;
+      term->value = RAPTOR_GOOD_CAST(size_t, start - output);
+      term->value_len = RAPTOR_GOOD_CAST(size_t, out - start);
+      out++;
+
+      if(len && *p == '@') {
+        int has_subtag = 0;
+        int subtag_start = 0;
+
+        p++;
+        len--;
+
+        start = out;
+        while(len) {
+          unsigned char c = *p;
+          int valid;
+
+          if(c > 0x7f || c == '\\')
+            return 1;
+
+          valid = IS_ASCII_ALPHA(c);
+          if(out > start)
+            valid = (valid || IS_ASCII_DIGIT(c) || c == '-' || c == '_');
+          if(!valid ||
+             (subtag_start && (c == '-' || c == '_')) ||
+             (!has_subtag && IS_ASCII_DIGIT(c)))
+            break;
+
+          *out++ = c;
+          if(c == '-' || c == '_')
+            has_subtag = 1;
+          subtag_start = (c == '-' || c == '_');
+          p++;
+          len--;
+        }
+
+        if(subtag_start || out == start || out - start > 255)
+          return 1;
+        *out = '\0';
+
+        term->language = RAPTOR_GOOD_CAST(size_t, start - output);
+        term->language_len = RAPTOR_GOOD_CAST(size_t, out - start);
+        out++;
+      }
+
+      if(len > 1 && *p == '^' && p[1] == '^') {
+        /* a language and a datatype is reported by the serial parser */
+        if(term->language_len)
+          return 1;
+
+        p += 2;
+        len -= 2;
+        if(!len || *p != '<')
+          return 1;
+        p++;
+        len--;
+
+        if(raptor_ntriples_decode_iri(&p, &len, &out,
+                                      &term->datatype, &term->datatype_len,
+                                      output))
+          return 1;
+      }
+      break;
+
+    default:
+      return 1;
+  }
+
+  *p_p = p;
+  *len_p = len;
+  *out_p = out;
+
+  return 0;
+}
+
+
+/*
+ * raptor_ntriples_decode_line:
+ * @batch: batch
+ * @line: line to decode
+ * @out_p: pointer to output pointer (in/out)
+ *
+ * INTERNAL - Decode a line the way raptor_ntriples_parse_line() parses it
+ *
+ * Runs on a worker thread.
+ *
+ * Return value: line status
+ */
+static raptor_ntriples_line_status
+raptor_ntriples_decode_line(raptor_ntriples_batch* batch,
+                            raptor_ntriples_batch_line* line,
+                            unsigned char** out_p)
+{
+  const unsigned char* p = batch->input + line->offset;
+  size_t len = line->length;
+  int i;
+
+  while(len > 0 && isspace((int)*p)) {
+    p++;
+    len--;
+  }
+
+  if(!len || *p == '#')
+    return RAPTOR_NTRIPLES_LINE_SKIP;
+
+  while(len > 0 && isspace((int)p[len - 1]))
+    len--;
+
+  for(i = 0; i < MAX_NTRIPLES_TERMS + 1; i++) {
+    if(!len) {
+      /* the final '.' is optional in the serial parser too */
+      if(i == 3 || (batch->is_nquads && i == 4))
+        break;
+      return RAPTOR_NTRIPLES_LINE_SERIAL;
+    }
+
+    /* too many terms; literal graphs are warned about serially */
+    if(i == (batch->is_nquads ? 4 : 3) ||
+       (i == 1 && *p != '<') ||
+       (i != 2 && *p == '"'))
+      return RAPTOR_NTRIPLES_LINE_SERIAL;
+
+    if(raptor_ntriples_decode_term(&p, &len, out_p, &line->terms[i],
+                                   batch->output))
+      return RAPTOR_NTRIPLES_LINE_SERIAL;
+    line->terms_count = i + 1;
+
+    while(len > 0 && isspace((int)*p)) {
+      p++;
+      len--;
+    }
+
+    if(len > 0 && *p == '.') {
+      if(i < 2)
+        return RAPTOR_NTRIPLES_LINE_SERIAL;
+
+      p++;
+      len--;
+      while(len > 0 && isspace((int)*p)) {
+        p++;
+        len--;
+      }
+
+      /* Only a comment is allowed here */
+      if(len > 0 && *p != '#')
+        return RAPTOR_NTRIPLES_LINE_SERIAL;
+
+      break;
+    }
+  }
+
+  return RAPTOR_NTRIPLES_LINE_DECODED;
+}
+
+
+/*
+ * raptor_ntriples_decode_batch:
+ * @data: batch
+ *
+ * INTERNAL - Worker thread job to decode all the lines of a batch
+ */
+static void
+raptor_ntriples_decode_batch(void* data)
+{
+  raptor_ntriples_batch* batch = (raptor_ntriples_batch*)data;
+  unsigned char* out = batch->output;
+  int i;
+
+  for(i = 0; i < batch->lines_count; i++) {
+    raptor_ntriples_batch_line* line = &batch->lines[i];
+    unsigned char* line_out = out;
+
+    line->terms_count = 0;
+    line->status = raptor_ntriples_decode_line(batch, line, &out);
+    if(line->status != RAPTOR_NTRIPLES_LINE_DECODED)
+      /* reuse any output space */
+      out = line_out;
+  }
+}
+
+
+/*
+ * raptor_ntriples_emit_batch:
+ * @rdf_parser: parser
+ * @batch: decoded batch
+ *
+ * INTERNAL - Build terms and return statements for a decoded batch
+ *
+ * Return value: non-0 on a fatal error
+ */
+static int
+raptor_ntriples_emit_batch(raptor_parser* rdf_parser,
+                           raptor_ntriples_batch* batch)
+{
+  raptor_world* world = rdf_parser->world;
+  raptor_arena* arena = rdf_parser->arena;
+  int max_terms = batch->is_nquads ? 4 : 3;
+  int i;
+
+  for(i = 0; i < batch->lines_count; i++) {
+    raptor_ntriples_batch_line* line = &batch->lines[i];
+    raptor_term* terms[MAX_NTRIPLES_TERMS] = {NULL, NULL, NULL, NULL};
+    int t;
+
+    rdf_parser->locator.line = line->line;
+    rdf_parser->locator.column = 0;
+    rdf_parser->locator.byte = line->byte;
+
+    if(line->status == RAPTOR_NTRIPLES_LINE_SKIP)
+      continue;
+
+    if(line->status == RAPTOR_NTRIPLES_LINE_SERIAL) {
+      if(raptor_ntriples_parse_line(rdf_parser, batch->input + line->offset,
+                                    line->length, max_terms))
+        return 1;
+      continue;
+    }
+
+    for(t = 0; t < line->terms_count; t++) {
+      raptor_ntriples_decoded_term* dterm = &line->terms[t];
+      const unsigned char* value = batch->output + dterm->value;
+
+      if(dterm->type == RAPTOR_TERM_TYPE_URI)
+        terms[t] = raptor_new_term_from_counted_uri_string_in_arena(arena,
+                                                      world, value,
+                                                      dterm->value_len);
+      else if(dterm->type == RAPTOR_TERM_TYPE_BLANK)
+        terms[t] = raptor_new_term_from_counted_blank_in_arena(arena,
+                                                      world, value,
+                                                      dterm->value_len);
+      else {
+        raptor_uri* datatype_uri = NULL;
+        const unsigned char* language = NULL;
+
+        if(dterm->datatype_len) {
+          datatype_uri = raptor_new_uri_from_counted_string(world,
+                                           batch->output + dterm->datatype,
+                                           dterm->datatype_len);
+          if(!datatype_uri)
+            continue;
+        }
+        if(dterm->language_len)
+          language = batch->output + dterm->language;
+
+        terms[t] = raptor_new_term_from_counted_literal_in_arena(arena, world,
+                          value, dterm->value_len, datatype_uri,
+                          language,
+                          RAPTOR_GOOD_CAST(unsigned char, dterm->language_len));
+        if(datatype_uri)
+          raptor_free_uri(datatype_uri);
+      }
+    }
+
+    raptor_ntriples_generate_statement(rdf_parser, terms[0], terms[1],
+                                       terms[2], terms[3]);
+
+    rdf_parser->locator.byte += RAPTOR_BAD_CAST(int, line->length);
+  }
+
+  return 0;
+}
+
+
+/*
+ * raptor_ntriples_collect_batches:
+ * @rdf_parser: parser
+ * @max_pending: collect until no more than this many batches are pending
+ * @wait: non-0 to block until batches are done
+ *
+ * INTERNAL - Collect decoded batches from the workers and emit them
+ *
+ * After a fatal error, pending batches are collected and discarded.
+ *
+ * Return value: non-0 on a fatal error
+ */
+static int
+raptor_ntriples_collect_batches(raptor_parser* rdf_parser, int max_pending,
+                                int wait)
+{
+  raptor_ntriples_parser_context *ntriples_parser = (raptor_ntriples_parser_context*)rdf_parser->context;
+  raptor_workers* workers = ntriples_parser->workers;
+  int ordered = !RAPTOR_OPTIONS_GET_NUMERIC(rdf_parser,
+                                            RAPTOR_OPTION_PARSE_UNORDERED);
+  int rc = 0;
+
+  while(raptor_workers_get_pending(workers) > max_pending) {
+    raptor_ntriples_batch* batch;
+
+    batch = (raptor_ntriples_batch*)raptor_workers_next_done(workers, ordered,
+                                                             wait || rc);
+    if(!batch)
+      break;
+
+    if(!rc)
+      rc = raptor_ntriples_emit_batch(rdf_parser, batch);
+    if(rc)
+      /* discard everything after a fatal error */
+      max_pending = 0;
+
+    /* keep for reuse */
+    batch->next = ntriples_parser->free_batches;
+    ntriples_parser->free_batches = batch;
+  }
+
+  return rc;
+}
+
+
+/*
+ * raptor_ntriples_submit_batch:
+ * @rdf_parser: parser
+ *
+ * INTERNAL - Hand the current batch to a worker
+ *
+ * Return value: non-0 on failure
+ */
+static int
+raptor_ntriples_submit_batch(raptor_parser* rdf_parser)
+{
+  raptor_ntriples_parser_context *ntriples_parser = (raptor_ntriples_parser_context*)rdf_parser->context;
+  raptor_ntriples_batch* batch = ntriples_parser->batch;
+  int max_pending;
+
+  if(!batch)
+    return 0;
+  ntriples_parser->batch = NULL;
+
+  if(batch->output_size < batch->input_length + 1) {
+    if(batch->output)
+      RAPTOR_FREE(char*, batch->output);
+    batch->output_size = batch->input_size + 1;
+    batch->output = RAPTOR_MALLOC(unsigned char*, batch->output_size);
+    if(!batch->output) {
+      raptor_free_ntriples_batch(batch);
+      return 1;
+    }
+  }
+
+  if(raptor_workers_submit(ntriples_parser->workers,
+                           raptor_ntriples_decode_batch, batch)) {
+    raptor_free_ntriples_batch(batch);
+    return 1;
+  }
+
+  /* bound the memory used by batches waiting to be emitted */
+  max_pending = raptor_workers_get_count(ntriples_parser->workers) *
+                RAPTOR_NTRIPLES_BATCHES_PER_THREAD;
+  if(raptor_ntriples_collect_batches(rdf_parser, max_pending, 1))
+    return 1;
+
+  /* and emit anything else that is ready now */
+  return raptor_ntriples_collect_batches(rdf_parser, 0, 0);
+}
+
+
+/*
+ * raptor_ntriples_batch_add_line:
+ * @rdf_parser: parser
+ * @line_start: NUL terminated line
+ * @len: length of line
+ * @locator: locator at the start of the line
+ *
+ * INTERNAL - Add a line to the current batch, submitting it when full
+ *
+ * Return value: non-0 on failure
+ */
+static int
+raptor_ntriples_batch_add_line(raptor_parser* rdf_parser,
+                               const unsigned char* line_start, size_t len,
+                               raptor_locator* locator)
+{
+  raptor_ntriples_parser_context *ntriples_parser = (raptor_ntriples_parser_context*)rdf_parser->context;
+  raptor_ntriples_batch* batch = ntriples_parser->batch;
+  raptor_ntriples_batch_line* line;
+
+  if(!batch) {
+    batch = ntriples_parser->free_batches;
+    if(batch)
+      ntriples_parser->free_batches = batch->next;
+    else {
+      batch = RAPTOR_CALLOC(raptor_ntriples_batch*, 1, sizeof(*batch));
+      if(!batch)
+        return 1;
+    }
+    batch->next = NULL;
+    batch->is_nquads = ntriples_parser->is_nquads;
+    batch->input_length = 0;
+    batch->lines_count = 0;
+    ntriples_parser->batch = batch;
+  }
+
+  if(RAPTOR_SIZE_T_ADD_OVERFLOWS(batch->input_length, len + 1))
+    return 1;
+  if(batch->input_length + len + 1 > batch->input_size) {
+    size_t new_size = batch->input_size ? batch->input_size : RAPTOR_NTRIPLES_BATCH_SIZE;
+    unsigned char* input;
+
+    while(new_size < batch->input_length + len + 1) {
+      if(RAPTOR_SIZE_T_ADD_OVERFLOWS(new_size, new_size))
+        return 1;
+      new_size += new_size;
+    }
+    input = RAPTOR_REALLOC(unsigned char*, batch->input, new_size);
+    if(!input)
+      return 1;
+    batch->input = input;
+    batch->input_size = new_size;
+  }
+
+  if(batch->lines_count == batch->lines_size) {
+    int new_size = batch->lines_size ? batch->lines_size * 2 : 1024;
+    raptor_ntriples_batch_line* lines;
+
+    lines = RAPTOR_REALLOC(raptor_ntriples_batch_line*, batch->lines,
+                           RAPTOR_GOOD_CAST(size_t, new_size) * sizeof(*lines));
+    if(!lines)
+      return 1;
+    batch->lines = lines;
+    batch->lines_size = new_size;
+  }
+
+  line = &batch->lines[batch->lines_count++];
+  line->offset = batch->input_length;
+  line->length = len;
+  line->line = locator->line;
+  line->byte = locator->byte;
+
+  memcpy(batch->input + batch->input_length, line_start, len);
+  batch->input_length += len;
+  batch->input[batch->input_length++] = '\0';
+
+  if(batch->input_length >= RAPTOR_NTRIPLES_BATCH_SIZE)
+    return raptor_ntriples_submit_batch(rdf_parser);
+
+  return 0;
+}
+
+
+/*
+ * raptor_ntriples_discard_batches:
+ * @ntriples_parser: N-Triples parser context
+ *
+ * INTERNAL - Wait for and discard any batches from an unfinished parse
+ */
+static void
+raptor_ntriples_discard_batches(raptor_ntriples_parser_context* ntriples_parser)
+{
+  if(ntriples_parser->workers) {
+    raptor_ntriples_batch* batch;
+
+    while((batch = (raptor_ntriples_batch*)raptor_workers_next_done(ntriples_parser->workers, 0, 1))) {
+      batch->next = ntriples_parser->free_batches;
+      ntriples_parser->free_batches = batch;
+    }
+  }
+
+  if(ntriples_parser->batch) {
+    ntriples_parser->batch->next = ntriples_parser->free_batches;
+    ntriples_parser->free_batches = ntriples_parser->batch;
+    ntriples_parser->batch = NULL;
+  }
+}
+
+
+/*
+ * raptor_ntriples_free_workers:
+ * @ntriples_parser: N-Triples parser context
+ *
+ * INTERNAL - Stop the worker threads and free all batches
+ */
+static void
+raptor_ntriples_free_workers(raptor_ntriples_parser_context* ntriples_parser)
+{
+  raptor_ntriples_discard_batches(ntriples_parser);
+
+  if(ntriples_parser->workers) {
+    raptor_free_workers(ntriples_parser->workers);
+    ntriples_parser->workers = NULL;
+  }
+
+  while(ntriples_parser->free_batches) {
+    raptor_ntriples_batch* batch = ntriples_parser->free_batches;
+    ntriples_parser->free_batches = batch->next;
+    raptor_free_ntriples_batch(batch);
+  }
+}
+
+
+/* Initial size of the input window; it grows by doubling */
+#define RAPTOR_NTRIPLES_WINDOW_MIN_SIZE 4096
+
+/*
+ * raptor_ntriples_window_append:
+ * @ntriples_parser: N-Triples parser context
+ * @s: bytes to append
+ * @len: length of @s
+ *
+ * INTERNAL - Append bytes to the input window
+ *
+ * Slides any unconsumed tail down to the start of the window (only
+ * the partial line is moved, never the consumed data) and grows the
+ * window geometrically when it is too small, so the number of
+ * allocations is logarithmic in the longest line rather than linear
+ * in the number of chunks.
+ *
+ * Return value: non-0 on failure
+ */
+static int
+raptor_ntriples_window_append(raptor_ntriples_parser_context *ntriples_parser,
+                              const unsigned char *s, size_t len)
+{
+  size_t unconsumed = ntriples_parser->line_length - ntriples_parser->offset;
+  size_t needed;
+
+  if(RAPTOR_SIZE_T_ADD_OVERFLOWS(unconsumed, len))
+    return 1;
+  needed = unconsumed + len;
+
+  if(ntriples_parser->offset) {
+    if(unconsumed)
+      memmove(ntriples_parser->line,
+              ntriples_parser->line + ntriples_parser->offset,
+              unconsumed);
+    ntriples_parser->line_length = unconsumed;
+    ntriples_parser->offset = 0;
+  }
+
+  if(needed > ntriples_parser->line_size) {
+    unsigned char *buffer;
+    size_t new_size = ntriples_parser->line_size;
+
+    if(!new_size)
+      new_size = RAPTOR_NTRIPLES_WINDOW_MIN_SIZE;
+    while(new_size < needed) {
+      if(RAPTOR_SIZE_T_ADD_OVERFLOWS(new_size, new_size)) {
+        new_size = needed;
+        break;
+      }
+      new_size += new_size;
+    }
+    if(RAPTOR_SIZE_T_ADD_OVERFLOWS(new_size, 1))
+      return 1;
+
+#if defined(RAPTOR_DEBUG) && RAPTOR_DEBUG > 1
+    RAPTOR_DEBUG3("growing window from %ld to %ld bytes\n",
+                  ntriples_parser->line_size, new_size);
+#endif
+    buffer = RAPTOR_REALLOC(unsigned char*, ntriples_parser->line,
+                            new_size + 1);
+    if(!buffer)
+      return 1;
+
+    ntriples_parser->line = buffer;
+    ntriples_parser->line_size = new_size;
+  }
+
+  memcpy(ntriples_parser->line + ntriples_parser->line_length, s, len);
+  ntriples_parser->line_length += len;
+  ntriples_parser->line[ntriples_parser->line_length] = '\0';
+
+  return 0;
+}
+
+
 static int
 raptor_ntriples_parse_chunk(raptor_parser* rdf_parser, 
                             const unsigned char *s, size_t len,
@@ -388,107 +1367,104 @@ raptor_ntriples_parse_chunk(raptor_parser* rdf_parser,
   raptor_ntriples_parser_context *ntriples_parser = (raptor_ntriples_parser_context*)rdf_parser->context;
   int max_terms = ntriples_parser->is_nquads ? 4 : 3;
   unsigned char* end_ptr;
-  size_t new_line_length;
+  raptor_locator *locator = &rdf_parser->locator;
+
+  /* in parallel parsing the statement locators are set per line */
+  if(ntriples_parser->workers)
+    locator = &ntriples_parser->split_locator;
 
 #if defined(RAPTOR_DEBUG) && RAPTOR_DEBUG > 1
   RAPTOR_DEBUG2("adding %d bytes to buffer\n", (unsigned int)len);
 #endif
 
   if(len) {
-    if(RAPTOR_SIZE_T_ADD_OVERFLOWS(ntriples_parser->line_length, len))
-      return 1;
-    new_line_length = ntriples_parser->line_length + len;
-    if(RAPTOR_SIZE_T_ADD_OVERFLOWS(new_line_length, 1))
+    if(raptor_ntriples_window_append(ntriples_parser, s, len))
       return 1;
-
-    buffer = RAPTOR_MALLOC(unsigned char*, new_line_length + 1);
-    if(!buffer)
-      return 1;
-
-    if(ntriples_parser->line_length) {
-      memcpy(buffer, ntriples_parser->line, ntriples_parser->line_length);
-      RAPTOR_FREE(char*, ntriples_parser->line);
-    }
-
-    ntriples_parser->line = buffer;
-
-    /* move pointer to end of cdata buffer */
-    ptr = buffer + ntriples_parser->line_length;
-
-    /* adjust stored length */
-    ntriples_parser->line_length = new_line_length;
-
-    /* now write new stuff at end of cdata buffer */
-    memcpy(ptr, s, len);
-    ptr += len;
-    *ptr = '\0';
-  } else
-    buffer = ntriples_parser->line;
-
+  }
 
 #if defined(RAPTOR_DEBUG) && RAPTOR_DEBUG > 1
-  RAPTOR_DEBUG2("buffer now %ld bytes\n", ntriples_parser->line_length);
+  RAPTOR_DEBUG3("window now %ld bytes (offset %ld)\n",
+                ntriples_parser->line_length, ntriples_parser->offset);
 #endif
 
-  if(!ntriples_parser->line_length)
-    return 0;
+  buffer = ntriples_parser->line;
+  if(!buffer)
+    goto done;
 
   ptr = buffer + ntriples_parser->offset;
   end_ptr = buffer + ntriples_parser->line_length;
   while((start = ptr) < end_ptr) {
     unsigned char *line_start = ptr;
+    int quote = '\0';
+    int in_uri = '\0';
+    int bq = 0;
 
 #if defined(RAPTOR_DEBUG) && RAPTOR_DEBUG > 1
   RAPTOR_DEBUG3("line buffer now '%s' (offset %ld)\n", ptr, ptr-(buffer+ntriples_parser->offset));
 #endif
 
-    /* skip \n when just seen \r - i.e. \r\n or CR LF */
-    if(ntriples_parser->last_char == '\r' && *ptr == '\n') {
+    if(ntriples_parser->scan_length) {
+      /* resume scanning a line that was split across chunks */
+      ptr += ntriples_parser->scan_length;
+      quote = ntriples_parser->scan_quote;
+      in_uri = ntriples_parser->scan_in_uri;
+      bq = ntriples_parser->scan_bq;
+      ntriples_parser->scan_length = 0;
+    } else if(ntriples_parser->last_char == '\r' && *ptr == '\n') {
+      /* skip \n when just seen \r - i.e. \r\n or CR LF */
 #if defined(RAPTOR_DEBUG) && RAPTOR_DEBUG > 1
       RAPTOR_DEBUG1("skipping a \\n\n");
 #endif
       ptr++;
-      rdf_parser->locator.byte++;
-      rdf_parser->locator.column = 0;
+      locator->byte++;
+      locator->column = 0;
+      ntriples_parser->last_char = '\n';
       start = line_start = ptr;
     }
 
-    if(1) {
-      int quote = '\0';
-      int in_uri = '\0';
-      int bq = 0;
-      while(ptr < end_ptr) {
-        if(!bq) {
-          if(*ptr == '\\') {
-            bq = 1;
-            ptr++;
-            continue;
-          }
+    while(ptr < end_ptr) {
+      if(!bq) {
+        /* skip over bytes that cannot end the line or change state */
+        ptr = RAPTOR_BAD_CAST(unsigned char*,
+                              raptor_scan_set_find(&ntriples_parser->delimiters,
+                                                   ptr, end_ptr));
+        if(ptr == end_ptr)
+          break;
 
-          if(*ptr == '<')
-            in_uri = 1;
-          else if (in_uri && *ptr == '>')
-            in_uri = 0;
-
-          if(!quote) {
-            if((!in_uri && *ptr == '\'') || *ptr == '"')
-              quote = *ptr;
-            if(*ptr == '\n' || *ptr == '\r')
-              break;
-          } else {
-            if(*ptr == quote)
-              quote = 0;
-          }
+        if(*ptr == '\\') {
+          bq = 1;
+          ptr++;
+          continue;
+        }
+
+        if(*ptr == '<')
+          in_uri = 1;
+        else if (in_uri && *ptr == '>')
+          in_uri = 0;
+
+        if(!quote) {
+          if((!in_uri && *ptr == '\'') || *ptr == '"')
+            quote = *ptr;
+          if(*ptr == '\n' || *ptr == '\r')
+            break;
+        } else {
+          if(*ptr == quote)
+            quote = 0;
         }
-        ptr++;
-        bq = 0;
       }
+      ptr++;
+      bq = 0;
     }
 
     if(ptr == end_ptr) {
-      if(!is_end)
-        /* middle of line */
+      if(!is_end) {
+        /* middle of line - remember how far it was scanned */
+        ntriples_parser->scan_length = RAPTOR_GOOD_CAST(size_t, ptr - line_start);
+        ntriples_parser->scan_quote = quote;
+        ntriples_parser->scan_in_uri = in_uri;
+        ntriples_parser->scan_bq = bq;
         break;
+      }
     } else {
 #if defined(RAPTOR_DEBUG) && RAPTOR_DEBUG > 1
       RAPTOR_DEBUG3("found newline \\x%02x at offset %ld\n", *ptr,
@@ -498,7 +1474,7 @@ raptor_ntriples_parse_chunk(raptor_parser* rdf_parser,
     }
     
     len = ptr - line_start;
-    rdf_parser->locator.column = 0;
+    locator->column = 0;
 
 #if defined(RAPTOR_DEBUG) && RAPTOR_DEBUG > 1
     RAPTOR_DEBUG2("line (%ld) : >>>", len);
@@ -506,15 +1482,19 @@ raptor_ntriples_parse_chunk(raptor_parser* rdf_parser,
     fputs("<<<\n", stderr);
 #endif
     *ptr = '\0';
-    if(raptor_ntriples_parse_line(rdf_parser, line_start, len, max_terms))
+    if(ntriples_parser->workers) {
+      if(raptor_ntriples_batch_add_line(rdf_parser, line_start, len, locator))
+        return 1;
+      locator->byte += RAPTOR_BAD_CAST(int, len);
+    } else if(raptor_ntriples_parse_line(rdf_parser, line_start, len, max_terms))
       return 1;
     
-    rdf_parser->locator.line++;
+    locator->line++;
 
     /* go past newline */
     if(ptr < end_ptr) {
       ptr++;
-      rdf_parser->locator.byte++;
+      locator->byte++;
     }
 
 #if defined(RAPTOR_DEBUG) && RAPTOR_DEBUG > 1
@@ -528,32 +1508,22 @@ raptor_ntriples_parse_chunk(raptor_parser* rdf_parser,
 
   ntriples_parser->offset = start - buffer;
 
-  len = ntriples_parser->line_length - ntriples_parser->offset;
-    
-  if(len && ntriples_parser->line_length != len) {
-    /* collapse buffer */
+  if(ntriples_parser->offset == ntriples_parser->line_length) {
+    /* window fully consumed; reuse it from the start */
+    ntriples_parser->offset = 0;
+    ntriples_parser->line_length = 0;
+  }
 
-#if defined(RAPTOR_DEBUG) && RAPTOR_DEBUG > 1
-    RAPTOR_DEBUG3("collapsing buffer from %ld to %ld bytes\n", ntriples_parser->line_length, len);
-#endif
-    buffer = RAPTOR_MALLOC(unsigned char*, len + 1);
-    if(!buffer)
+  done:
+  if(ntriples_parser->workers && is_end) {
+    /* all statements must be returned before the end of the graph */
+    if(raptor_ntriples_submit_batch(rdf_parser) ||
+       raptor_ntriples_collect_batches(rdf_parser, 0, 1))
       return 1;
 
-    memcpy(buffer, 
-           ntriples_parser->line + ntriples_parser->line_length - len,
-           len);
-    buffer[len] = '\0';
-
-    RAPTOR_FREE(char*, ntriples_parser->line);
-
-    ntriples_parser->line = buffer;
-    ntriples_parser->line_length -= ntriples_parser->offset;
-    ntriples_parser->offset = 0;
-
-#if defined(RAPTOR_DEBUG) && RAPTOR_DEBUG > 1
-    RAPTOR_DEBUG3("buffer now '%s' (%ld bytes)\n", ntriples_parser->line, ntriples_parser->line_length);
-#endif    
+    rdf_parser->locator.line = locator->line;
+    rdf_parser->locator.column = locator->column;
+    rdf_parser->locator.byte = locator->byte;
   }
 
   /* exit now, no more input */
@@ -580,6 +1550,7 @@ raptor_ntriples_parse_start(raptor_parser* rdf_parser)
 {
   raptor_locator *locator = &rdf_parser->locator;
   raptor_ntriples_parser_context *ntriples_parser = (raptor_ntriples_parser_context*)rdf_parser->context;
+  int threads;
 
   locator->line = 1;
   locator->column = 0;
@@ -587,7 +1558,30 @@ raptor_ntriples_parse_start(raptor_parser* rdf_parser)
 
   ntriples_parser->last_char = '\0';
 
-  return 0;
+  /* keep the window allocation for reuse but forget any contents */
+  ntriples_parser->line_length = 0;
+  ntriples_parser->offset = 0;
+  ntriples_parser->scan_length = 0;
+  ntriples_parser->scan_quote = 0;
+  ntriples_parser->scan_in_uri = 0;
+  ntriples_parser->scan_bq = 0;
+
+  /* drop any batches left from an unfinished parse */
+  raptor_ntriples_discard_batches(ntriples_parser);
+
+  threads = RAPTOR_OPTIONS_GET_NUMERIC(rdf_parser, RAPTOR_OPTION_PARSE_THREADS);
+  if(threads < 2)
+    raptor_ntriples_free_workers(ntriples_parser);
+  else if(!ntriples_parser->workers ||
+          raptor_workers_get_count(ntriples_parser->workers) != threads) {
+    raptor_ntriples_free_workers(ntriples_parser);
+    /* NULL without thread support; then parse serially */
+    ntriples_parser->workers = raptor_new_workers(threads);
+  }
+
+  ntriples_parser->split_locator = *locator;
+
+  return raptor_parser_start_arena(rdf_parser);
 }
 
 
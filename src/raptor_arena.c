@@ -0,0 +1,301 @@
+/* -*- Mode: c; c-basic-offset: 2 -*-
+ *
+ * raptor_arena.c - Raptor bump allocator for short-lived objects
+ *
+ * Copyright (C) 2026, David Beckett http://www.dajobe.org/
+ *
+ * This package is Free Software and part of Redland http://librdf.org/
+ *
+ * It is licensed under the following three licenses as alternatives:
+ *   1. GNU Lesser General Public License (LGPL) V2.1 or any newer version
+ *   2. GNU General Public License (GPL) V2 or any newer version
+ *   3. Apache License, V2.0 or any newer version
+ *
+ * You may not use this file except in compliance with at least one of
+ * the above three licenses.
+ *
+ * See LICENSE.html or LICENSE.txt at the top of this package for the
+ * complete terms and further detail along with the license texts for
+ * the licenses in COPYING.LIB, COPYING and LICENSE-2.0.txt respectively.
+ *
+ *
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include <raptor_config.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+
+/* Raptor includes */
+#include "raptor2.h"
+#include "raptor_internal.h"
+
+
+/*
+ * An arena hands out memory by bumping a pointer through a list of
+ * blocks.  Nothing is freed individually: raptor_arena_reset() makes
+ * all of it available again at once and raptor_free_arena() returns
+ * it to the system.
+ *
+ * Blocks of the standard size are kept over a reset so that an arena
+ * reset after every statement does no malloc at all once it is warm.
+ * Requests bigger than a block get a block of their own which is
+ * freed on the next reset.
+ *
+ * An arena can also hold references to URIs, which are released on
+ * reset, so that objects in the arena can point at interned URIs.
+ */
+
+
+/* alignment of every allocation */
+#define RAPTOR_ARENA_ALIGN (2 * sizeof(void*))
+#define RAPTOR_ARENA_ALIGN_SIZE(size) \
+  (((size) + RAPTOR_ARENA_ALIGN - 1) & ~(RAPTOR_ARENA_ALIGN - 1))
+
+/* default size of a block, not including the block header */
+#define RAPTOR_ARENA_DEFAULT_BLOCK_SIZE 8192
+
+
+typedef struct raptor_arena_block_s raptor_arena_block;
+
+struct raptor_arena_block_s {
+  raptor_arena_block* next;
+
+  /* bytes of data in the block and bytes used */
+  size_t size;
+  size_t used;
+};
+
+/* offset of the data after the block header */
+#define RAPTOR_ARENA_BLOCK_HEADER_SIZE \
+  RAPTOR_ARENA_ALIGN_SIZE(sizeof(raptor_arena_block))
+
+#define RAPTOR_ARENA_BLOCK_DATA(block) \
+  (RAPTOR_GOOD_CAST(unsigned char*, block) + RAPTOR_ARENA_BLOCK_HEADER_SIZE)
+
+
+struct raptor_arena_s {
+  /* standard sized blocks; kept over a reset */
+  raptor_arena_block* blocks;
+  /* block being allocated from */
+  raptor_arena_block* current;
+  /* oversized blocks; freed on reset */
+  raptor_arena_block* large_blocks;
+
+  size_t block_size;
+
+  /* URI references released on reset */
+  raptor_uri** uris;
+  int uris_count;
+  int uris_size;
+};
+
+
+static raptor_arena_block*
+raptor_new_arena_block(size_t size)
+{
+  raptor_arena_block* block;
+
+  if(RAPTOR_SIZE_T_ADD_OVERFLOWS(size, RAPTOR_ARENA_BLOCK_HEADER_SIZE))
+    return NULL;
+
+  block = RAPTOR_MALLOC(raptor_arena_block*,
+                        RAPTOR_ARENA_BLOCK_HEADER_SIZE + size);
+  if(!block)
+    return NULL;
+
+  block->next = NULL;
+  block->size = size;
+  block->used = 0;
+
+  return block;
+}
+
+
+static void
+raptor_free_arena_blocks(raptor_arena_block* block)
+{
+  while(block) {
+    raptor_arena_block* next = block->next;
+    RAPTOR_FREE(raptor_arena_block, block);
+    block = next;
+  }
+}
+
+
+/*
+ * raptor_new_arena:
+ * @block_size: size of blocks to allocate or 0 for the default
+ *
+ * INTERNAL - Constructor - create a new arena
+ *
+ * No memory is allocated for blocks until the first allocation.
+ *
+ * Return value: new arena or NULL on failure
+ */
+raptor_arena*
+raptor_new_arena(size_t block_size)
+{
+  raptor_arena* arena;
+
+  arena = RAPTOR_CALLOC(raptor_arena*, 1, sizeof(*arena));
+  if(!arena)
+    return NULL;
+
+  if(!block_size)
+    block_size = RAPTOR_ARENA_DEFAULT_BLOCK_SIZE;
+  arena->block_size = RAPTOR_ARENA_ALIGN_SIZE(block_size);
+
+  return arena;
+}
+
+
+/*
+ * raptor_free_arena:
+ * @arena: arena
+ *
+ * INTERNAL - Destructor - release the URIs and free all the memory
+ */
+void
+raptor_free_arena(raptor_arena* arena)
+{
+  if(!arena)
+    return;
+
+  raptor_arena_reset(arena);
+
+  raptor_free_arena_blocks(arena->blocks);
+  if(arena->uris)
+    RAPTOR_FREE(raptor_uri**, arena->uris);
+
+  RAPTOR_FREE(raptor_arena, arena);
+}
+
+
+/*
+ * raptor_arena_reset:
+ * @arena: arena
+ *
+ * INTERNAL - Release the URIs and make all the memory free for reuse
+ *
+ * Every pointer returned by raptor_arena_alloc() is invalid afterwards.
+ */
+void
+raptor_arena_reset(raptor_arena* arena)
+{
+  int i;
+
+  for(i = 0; i < arena->uris_count; i++)
+    raptor_free_uri(arena->uris[i]);
+  arena->uris_count = 0;
+
+  raptor_free_arena_blocks(arena->large_blocks);
+  arena->large_blocks = NULL;
+
+  arena->current = arena->blocks;
+  if(arena->current)
+    arena->current->used = 0;
+}
+
+
+/*
+ * raptor_arena_alloc:
+ * @arena: arena
+ * @size: number of bytes
+ *
+ * INTERNAL - Allocate memory from an arena
+ *
+ * The memory is not initialised and is suitably aligned for any
+ * raptor structure.  It is valid until the arena is reset or freed.
+ *
+ * Return value: pointer to memory or NULL on failure
+ */
+void*
+raptor_arena_alloc(raptor_arena* arena, size_t size)
+{
+  raptor_arena_block* block;
+  void* p;
+
+  if(RAPTOR_SIZE_T_ADD_OVERFLOWS(size, RAPTOR_ARENA_ALIGN))
+    return NULL;
+  size = RAPTOR_ARENA_ALIGN_SIZE(size);
+  if(!size)
+    size = RAPTOR_ARENA_ALIGN;
+
+  if(size > arena->block_size) {
+    block = raptor_new_arena_block(size);
+    if(!block)
+      return NULL;
+    block->next = arena->large_blocks;
+    arena->large_blocks = block;
+    return RAPTOR_ARENA_BLOCK_DATA(block);
+  }
+
+  block = arena->current;
+  if(!block || block->size - block->used < size) {
+    if(block && block->next) {
+      /* reuse a block kept from before the last reset */
+      block = block->next;
+      block->used = 0;
+    } else {
+      raptor_arena_block* new_block;
+
+      new_block = raptor_new_arena_block(arena->block_size);
+      if(!new_block)
+        return NULL;
+      if(block)
+        block->next = new_block;
+      else
+        arena->blocks = new_block;
+      block = new_block;
+    }
+    arena->current = block;
+  }
+
+  p = RAPTOR_ARENA_BLOCK_DATA(block) + block->used;
+  block->used += size;
+
+  return p;
+}
+
+
+/*
+ * raptor_arena_add_uri:
+ * @arena: arena
+ * @uri: URI
+ *
+ * INTERNAL - Give the arena a URI reference to release on reset
+ *
+ * The arena takes ownership of the reference @uri; it is released
+ * immediately on failure.
+ *
+ * Return value: non-0 on failure
+ */
+int
+raptor_arena_add_uri(raptor_arena* arena, raptor_uri* uri)
+{
+  if(arena->uris_count == arena->uris_size) {
+    int new_size = arena->uris_size ? arena->uris_size << 1 : 8;
+    raptor_uri** new_uris;
+
+    new_uris = RAPTOR_REALLOC(raptor_uri**, arena->uris,
+                              RAPTOR_GOOD_CAST(size_t, new_size) *
+                              sizeof(raptor_uri*));
+    if(!new_uris) {
+      raptor_free_uri(uri);
+      return 1;
+    }
+    arena->uris = new_uris;
+    arena->uris_size = new_size;
+  }
+
+  arena->uris[arena->uris_count++] = uri;
+
+  return 0;
+}
@@ -120,6 +120,9 @@ const unsigned int raptor_version_decimal = RAPTOR_VERSION_DECIMAL;
  *
  * The raptor_world is initialized with raptor_world_open().
  *
+ * An opened world can be shared between threads with the limits
+ * described in the world section of the documentation.
+ *
  * Return value: uninitialized raptor_world object or NULL on failure
  */
 raptor_world *
@@ -296,7 +299,7 @@ raptor_world_default_generate_bnodeid_handler(void *user_data,
   if(user_bnodeid)
     return user_bnodeid;
 
-  id = ++world->default_generate_bnodeid_handler_base;
+  id = RAPTOR_ATOMIC_INCREMENT(&world->default_generate_bnodeid_handler_base);
 
   id_length = raptor_format_integer(NULL, 0, id, /* base */ 10, -1, '\0');
 
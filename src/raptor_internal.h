@@ -42,6 +42,11 @@ extern "C" {
 #undef HAVE_STDLIB_H
 #endif
 
+/* for the locks on world data shared between threads */
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
 /* Some internal functions are needed by the test programs */
 #ifndef RAPTOR_INTERNAL_API
 #  if defined(_WIN32) || defined(__CYGWIN__)
@@ -248,6 +253,9 @@ typedef struct raptor_parser_factory_s raptor_parser_factory;
 typedef struct raptor_serializer_factory_s raptor_serializer_factory;
 typedef struct raptor_id_set_s raptor_id_set;
 typedef struct raptor_uri_detail_s raptor_uri_detail;
+typedef struct raptor_uri_table_s raptor_uri_table;
+typedef struct raptor_arena_s raptor_arena;
+typedef struct raptor_qname_cache_s raptor_qname_cache;
 
 
 /* raptor_option.c */
@@ -458,6 +466,9 @@ struct raptor_namespace_stack_s {
 
   raptor_uri *rdf_ms_uri;
   raptor_uri *rdf_schema_uri;
+
+  /* optional cache of qname string to URI or NULL */
+  raptor_qname_cache* qname_cache;
 };
 
 
@@ -504,6 +515,12 @@ raptor_namespace** raptor_namespace_stack_to_array(raptor_namespace_stack *nstac
 #define RAPTOR_READ_BUFFER_SIZE 4096
 #endif
 
+/* Largest read block size that can be set with the readBlockSize option */
+#define RAPTOR_READ_BLOCK_MAX_SIZE (64 * 1024 * 1024)
+
+/* Size the adaptive read block size grows to */
+#define RAPTOR_READ_BLOCK_ADAPTIVE_MAX_SIZE (1024 * 1024)
+
 
 /*
  * Raptor parser object
@@ -553,6 +570,13 @@ struct raptor_parser_s {
   /* parser callbacks */
   raptor_statement_handler statement_handler;
 
+  /* batch callback used when statement_handler is NULL, with the
+   * pending statements (or NULL before the first) */
+  raptor_statement_batch_handler statement_batch_handler;
+  raptor_statement* statement_batch;
+  int statement_batch_size;
+  int statement_batch_count;
+
   raptor_graph_mark_handler graph_mark_handler;
 
   void* uri_filter_user_data;
@@ -578,6 +602,14 @@ struct raptor_parser_s {
 
   /* internal read buffer */
   unsigned char buffer[RAPTOR_READ_BUFFER_SIZE + 1];
+
+  /* read buffer for blocks larger than @buffer (or NULL) */
+  unsigned char* read_buffer;
+  size_t read_buffer_size;
+
+  /* arena for the terms of the statement being returned when
+   * RAPTOR_OPTION_PARSE_ARENA is set (or NULL) */
+  raptor_arena* arena;
 };
 
 
@@ -760,10 +792,49 @@ RAPTOR_INTERNAL_API const char* raptor_basename(const char *name);
 #define RAPTOR_SIZE_T_MUL_OVERFLOWS(a, b) \
   ((size_t)(a) && (size_t)(b) > (size_t)-1 / (size_t)(a))
 #endif
+
+/* Reference counts shared between threads.  INCREMENT and DECREMENT
+ * return the new value; COMPARE_AND_SWAP stores @new_value if *@p is
+ * @old_value and otherwise loads *@p into the lvalue @old_value. */
+#ifdef HAVE_ATOMIC_BUILTINS
+#define RAPTOR_ATOMIC_INCREMENT(p) __atomic_add_fetch((p), 1, __ATOMIC_RELAXED)
+#define RAPTOR_ATOMIC_DECREMENT(p) __atomic_sub_fetch((p), 1, __ATOMIC_ACQ_REL)
+#define RAPTOR_ATOMIC_LOAD(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#define RAPTOR_ATOMIC_COMPARE_AND_SWAP(p, old_value, new_value) \
+  __atomic_compare_exchange_n((p), &(old_value), (new_value), 0, \
+                              __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)
+#else
+#define RAPTOR_ATOMIC_INCREMENT(p) (++*(p))
+#define RAPTOR_ATOMIC_DECREMENT(p) (--*(p))
+#define RAPTOR_ATOMIC_LOAD(p) (*(p))
+#define RAPTOR_ATOMIC_COMPARE_AND_SWAP(p, old_value, new_value) \
+  ((*(p) == (old_value)) ? (*(p) = (new_value), 1) : ((old_value) = *(p), 0))
+#endif
+
+/* Locks for world data shared between threads */
+#ifdef HAVE_PTHREAD
+typedef pthread_mutex_t raptor_mutex;
+#define RAPTOR_MUTEX_INIT(m) pthread_mutex_init((m), NULL)
+#define RAPTOR_MUTEX_DESTROY(m) pthread_mutex_destroy(m)
+#define RAPTOR_MUTEX_LOCK(m) pthread_mutex_lock(m)
+#define RAPTOR_MUTEX_UNLOCK(m) pthread_mutex_unlock(m)
+#else
+typedef int raptor_mutex;
+#define RAPTOR_MUTEX_INIT(m) (*(m) = 0)
+#define RAPTOR_MUTEX_DESTROY(m) do { } while(0)
+#define RAPTOR_MUTEX_LOCK(m) do { } while(0)
+#define RAPTOR_MUTEX_UNLOCK(m) do { } while(0)
+#endif
 int raptor_term_print_as_ntriples(const raptor_term *term, FILE* stream);
+raptor_term* raptor_new_term_from_uri_in_arena(raptor_arena* arena, raptor_world* world, raptor_uri* uri);
+raptor_term* raptor_new_term_from_counted_uri_string_in_arena(raptor_arena* arena, raptor_world* world, const unsigned char *uri_string, size_t length);
+raptor_term* raptor_new_term_from_counted_literal_in_arena(raptor_arena* arena, raptor_world* world, const unsigned char* literal, size_t literal_len, raptor_uri* datatype, const unsigned char* language, unsigned char language_len);
+raptor_term* raptor_new_term_from_counted_blank_in_arena(raptor_arena* arena, raptor_world* world, const unsigned char* blank, size_t length);
+raptor_term* raptor_new_term_from_counted_literal_owned(raptor_world* world, unsigned char* literal, size_t literal_len, raptor_uri* datatype, unsigned char* language);
+raptor_term* raptor_new_term_from_counted_blank_owned(raptor_world* world, unsigned char* blank, size_t length);
 
 /* raptor_ntriples.c */
-size_t raptor_ntriples_parse_term(raptor_world* world, raptor_locator* locator, unsigned char *string, size_t *len_p, raptor_term** term_p, int allow_turtle);
+size_t raptor_ntriples_parse_term(raptor_world* world, raptor_arena* arena, raptor_locator* locator, unsigned char *string, size_t *len_p, raptor_term** term_p, int allow_turtle);
 
 /* raptor_parse.c */
 raptor_parser_factory* raptor_world_get_parser_factory(raptor_world* world, const char *name);  
@@ -782,6 +853,7 @@ void raptor_world_internal_set_ignore_errors(raptor_world* world, int flag);
 void raptor_log_error_varargs(raptor_world* world, raptor_log_level level, raptor_locator* locator, const char* message, va_list arguments) RAPTOR_PRINTF_FORMAT(4, 0);
 RAPTOR_INTERNAL_API void raptor_log_error_formatted(raptor_world* world, raptor_log_level level, raptor_locator* locator, const char* message, ...) RAPTOR_PRINTF_FORMAT(4, 5);
 void raptor_log_error(raptor_world* world, raptor_log_level level, raptor_locator* locator, const char* message);
+int raptor_log_set_thread_message_count(int* count);
 
 
 /* raptor_parse.c */
@@ -802,6 +874,15 @@ void raptor_rdfxml_parser_stats_print(raptor_rdfxml_parser* rdf_xml_parser, FILE
 
 void raptor_parser_copy_flags_state(raptor_parser *to_parser, raptor_parser *from_parser);
 int raptor_parser_copy_user_state(raptor_parser *to_parser, raptor_parser *from_parser);
+void raptor_parser_emit_statement(raptor_parser* parser, raptor_statement* statement);
+void raptor_parser_flush_statements(raptor_parser* parser);
+
+/* default number of statements passed to a raptor_statement_batch_handler */
+#define RAPTOR_STATEMENT_BATCH_DEFAULT_SIZE 1024
+
+/* non-0 if statements generated by @parser go anywhere */
+#define RAPTOR_PARSER_HAS_STATEMENT_HANDLER(parser) \
+  ((parser)->statement_handler || (parser)->statement_batch_handler)
 
 /* raptor_general.c */
 extern int raptor_valid_xml_ID(raptor_parser *rdf_parser, const unsigned char *string);
@@ -831,6 +912,9 @@ void raptor_namespace_print(FILE *stream, raptor_namespace* ns);
 #endif
 
 void raptor_parser_start_namespace(raptor_parser* rdf_parser, raptor_namespace* nspace);
+int raptor_namespaces_enable_qname_cache(raptor_namespace_stack *nstack);
+raptor_uri* raptor_namespaces_qname_cache_find(raptor_namespace_stack *nstack, const unsigned char *name, size_t name_len);
+int raptor_namespaces_qname_cache_add(raptor_namespace_stack *nstack, const unsigned char *name, size_t name_len, raptor_uri* uri);
 
 
 /* 
@@ -962,6 +1046,7 @@ void raptor_parser_save_content(raptor_parser* rdf_parser, int save);
 const unsigned char* raptor_parser_get_content(raptor_parser* rdf_parser, size_t* length_p);
 void raptor_parser_start_graph(raptor_parser* parser, raptor_uri* uri, int is_declared);
 void raptor_parser_end_graph(raptor_parser* parser, raptor_uri* uri, int is_declared);
+int raptor_parser_start_arena(raptor_parser* rdf_parser);
 
 /* raptor_rss.c */
 int raptor_init_serializer_rss10(raptor_world* world);
@@ -1294,6 +1379,7 @@ typedef void (*raptor_simple_message_handler)(void *user_data, const char *messa
 
 
 /* turtle_common.c */
+RAPTOR_INTERNAL_API unsigned char* raptor_turtle_decode_string(const unsigned char *text, size_t len, int delim, raptor_simple_message_handler error_handler, void *error_data, int is_uri, size_t *len_p);
 RAPTOR_INTERNAL_API int raptor_stringbuffer_append_turtle_string(raptor_stringbuffer* stringbuffer, const unsigned char *text, size_t len, int delim, raptor_simple_message_handler error_handler, void *error_data, int is_uri);
 
 
@@ -1431,6 +1517,49 @@ int raptor_json_writer_key_uri_value(raptor_json_writer* json_writer, const char
 /* raptor_memstr.c */
 const char* raptor_memstr(const char *haystack, size_t haystack_len, const char *needle);
 
+/* raptor_scan.c */
+#define RAPTOR_SCAN_SET_MAX 8
+
+typedef struct raptor_scan_set_s raptor_scan_set;
+
+typedef const unsigned char* (*raptor_scan_find_handler)(const raptor_scan_set* set, const unsigned char* p, const unsigned char* end);
+
+/*
+ * Set of up to RAPTOR_SCAN_SET_MAX bytes to search for, with the
+ * search function chosen for the CPU by raptor_scan_set_init()
+ */
+struct raptor_scan_set_s {
+  int count;
+  unsigned char bytes[RAPTOR_SCAN_SET_MAX];
+  /* byte value lookup table used by the scalar search and tails */
+  unsigned char member[256];
+  raptor_scan_find_handler find;
+};
+
+int raptor_scan_set_init(raptor_scan_set* set, const unsigned char* bytes, int count);
+
+/* return pointer to the first byte in @set within [@p, @end) or @end */
+#define raptor_scan_set_find(set, p, end) ((set)->find(set, p, end))
+
+/* raptor_workers.c */
+typedef struct raptor_workers_s raptor_workers;
+
+typedef void (*raptor_workers_job_handler)(void* data);
+
+raptor_workers* raptor_new_workers(int count);
+void raptor_free_workers(raptor_workers* workers);
+int raptor_workers_get_count(raptor_workers* workers);
+int raptor_workers_submit(raptor_workers* workers, raptor_workers_job_handler handler, void* data);
+int raptor_workers_get_pending(raptor_workers* workers);
+void* raptor_workers_next_done(raptor_workers* workers, int ordered, int wait);
+
+/* raptor_arena.c */
+raptor_arena* raptor_new_arena(size_t block_size);
+void raptor_free_arena(raptor_arena* arena);
+void raptor_arena_reset(raptor_arena* arena);
+void* raptor_arena_alloc(raptor_arena* arena, size_t size);
+int raptor_arena_add_uri(raptor_arena* arena, raptor_uri* uri);
+
 /* raptor_serialize_rdfxmla.c special functions for embedding rdf/xml */
 int raptor_rdfxmla_serialize_set_write_rdf_RDF(raptor_serializer* serializer, int value);
 int raptor_rdfxmla_serialize_set_xml_writer(raptor_serializer* serializer, raptor_xml_writer* xml_writer, raptor_namespace_stack *nstack);
@@ -1512,15 +1641,13 @@ struct raptor_world_s {
   xmlGenericErrorFunc libxml_saved_generic_error_handler;
 #endif  
 
-  raptor_avltree *uris_tree;
+  /* interned URIs */
+  raptor_uri_table *uris_table;
 
   raptor_uri* concepts[RDF_NS_LAST + 1];
 
   raptor_term* terms[RDF_NS_LAST + 1];
 
-  /* last log message - points to data it does not own */
-  raptor_log_message message;
-
   /* should */
   int uri_interning;
 
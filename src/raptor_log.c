@@ -54,6 +54,76 @@ static const char* const raptor_log_level_labels[RAPTOR_LOG_LEVEL_LAST + 1] = {
 };
 
 
+/* log messages from the current thread are counted here rather than
+ * reported when set by raptor_log_set_thread_message_count() */
+#ifdef HAVE_PTHREAD
+static pthread_key_t raptor_log_thread_count_key;
+static pthread_once_t raptor_log_thread_count_once = PTHREAD_ONCE_INIT;
+static int raptor_log_thread_count_key_failed = 0;
+
+static void
+raptor_log_thread_count_key_init(void)
+{
+  if(pthread_key_create(&raptor_log_thread_count_key, NULL))
+    raptor_log_thread_count_key_failed = 1;
+}
+#else
+static int* raptor_log_thread_count = NULL;
+#endif
+
+
+/*
+ * raptor_log_set_thread_message_count:
+ * @count: pointer to the count or NULL to report messages again
+ *
+ * INTERNAL - Count log messages from the current thread instead of reporting them
+ *
+ * For work done on a worker thread that is done again on the calling
+ * thread, where the messages are reported, if anything was logged.
+ *
+ * Return value: non-0 on failure
+ */
+int
+raptor_log_set_thread_message_count(int* count)
+{
+#ifdef HAVE_PTHREAD
+  pthread_once(&raptor_log_thread_count_once,
+               raptor_log_thread_count_key_init);
+  if(raptor_log_thread_count_key_failed)
+    return 1;
+
+  return pthread_setspecific(raptor_log_thread_count_key, count) != 0;
+#else
+  raptor_log_thread_count = count;
+  return 0;
+#endif
+}
+
+
+/* Return non-0 if a message from the current thread was counted */
+static int
+raptor_log_count_thread_message(void)
+{
+  int* count;
+
+#ifdef HAVE_PTHREAD
+  pthread_once(&raptor_log_thread_count_once,
+               raptor_log_thread_count_key_init);
+  if(raptor_log_thread_count_key_failed)
+    return 0;
+
+  count = (int*)pthread_getspecific(raptor_log_thread_count_key);
+#else
+  count = raptor_log_thread_count;
+#endif
+  if(!count)
+    return 0;
+
+  (*count)++;
+  return 1;
+}
+
+
 /**
  * raptor_log_level_get_label:
  * @level: log message level
@@ -80,6 +150,9 @@ raptor_log_error_varargs(raptor_world* world, raptor_log_level level,
   if(level == RAPTOR_LOG_LEVEL_NONE)
     return;
 
+  if(raptor_log_count_thread_message())
+    return;
+
   if(world && world->internal_ignore_errors)
     return;
 
@@ -129,23 +202,29 @@ raptor_log_error(raptor_world* world, raptor_log_level level,
   if(level == RAPTOR_LOG_LEVEL_NONE)
     return;
 
+  if(raptor_log_count_thread_message())
+    return;
+
   if(world) {
+    /* on the stack as parsers in several threads may log at once */
+    raptor_log_message message;
+
     if(world->internal_ignore_errors)
       return;
 
-    memset(&world->message, '\0', sizeof(world->message));
-    world->message.code = -1;
-    world->message.domain = RAPTOR_DOMAIN_NONE;
-    world->message.level = level;
-    world->message.locator = locator;
-    world->message.text = text;
+    memset(&message, '\0', sizeof(message));
+    message.code = -1;
+    message.domain = RAPTOR_DOMAIN_NONE;
+    message.level = level;
+    message.locator = locator;
+    message.text = text;
   
     handler = world->message_handler;
     if(handler) {
       /* This is the place in raptor that ALL of the user error handler
        * functions are called.
        */
-      handler(world->message_handler_user_data, &world->message);
+      handler(world->message_handler_user_data, &message);
       return;
     }
   }
@@ -112,6 +112,259 @@ raptor_hash_ns_string(const unsigned char *str, int length)
 }
 
 
+/*
+ * Cache of qname strings to URIs
+ *
+ * Parsers that expand the same prefixed names over and over can ask
+ * for a cache so each one is turned into a URI only once.  It is an
+ * open-addressing table keyed on the qname string as written, so it
+ * is emptied whenever a namespace is started or ended since that can
+ * change what any of the strings expand to.
+ */
+
+/* Initial number of slots in the qname cache; always a power of 2 */
+#define RAPTOR_QNAME_CACHE_INITIAL_SIZE 256
+
+/* Maximum number of entries before the cache is emptied */
+#define RAPTOR_QNAME_CACHE_MAX_COUNT 16384
+
+typedef struct {
+  /* qname string or NULL if the slot is empty */
+  unsigned char* name;
+  size_t name_len;
+  unsigned int hash;
+  /* URI reference owned by the cache */
+  raptor_uri* uri;
+} raptor_qname_cache_entry;
+
+struct raptor_qname_cache_s {
+  raptor_qname_cache_entry* entries;
+  /* number of slots in @entries; always a power of 2 */
+  int size;
+  /* number of slots used */
+  int count;
+};
+
+
+static unsigned int
+raptor_qname_cache_hash(const unsigned char *name, size_t name_len)
+{
+  unsigned int hash = 2166136261U;
+
+  while(name_len--) {
+    hash ^= *name++;
+    hash *= 16777619U;
+  }
+
+  return hash;
+}
+
+
+static raptor_qname_cache*
+raptor_new_qname_cache(void)
+{
+  raptor_qname_cache* cache;
+
+  cache = RAPTOR_CALLOC(raptor_qname_cache*, 1, sizeof(*cache));
+  if(!cache)
+    return NULL;
+
+  cache->entries = RAPTOR_CALLOC(raptor_qname_cache_entry*,
+                                 RAPTOR_QNAME_CACHE_INITIAL_SIZE,
+                                 sizeof(raptor_qname_cache_entry));
+  if(!cache->entries) {
+    RAPTOR_FREE(raptor_qname_cache, cache);
+    return NULL;
+  }
+  cache->size = RAPTOR_QNAME_CACHE_INITIAL_SIZE;
+
+  return cache;
+}
+
+
+static void
+raptor_qname_cache_clear(raptor_qname_cache* cache)
+{
+  int i;
+
+  if(!cache->count)
+    return;
+
+  for(i = 0; i < cache->size; i++) {
+    raptor_qname_cache_entry* entry = &cache->entries[i];
+
+    if(entry->name) {
+      RAPTOR_FREE(char*, entry->name);
+      raptor_free_uri(entry->uri);
+      entry->name = NULL;
+      entry->uri = NULL;
+    }
+  }
+  cache->count = 0;
+}
+
+
+static void
+raptor_free_qname_cache(raptor_qname_cache* cache)
+{
+  raptor_qname_cache_clear(cache);
+  RAPTOR_FREE(raptor_qname_cache_entry*, cache->entries);
+  RAPTOR_FREE(raptor_qname_cache, cache);
+}
+
+
+/* double the size of the cache table */
+static int
+raptor_qname_cache_grow(raptor_qname_cache* cache)
+{
+  raptor_qname_cache_entry* entries;
+  int new_size = cache->size << 1;
+  unsigned int mask = RAPTOR_GOOD_CAST(unsigned int, new_size - 1);
+  int i;
+
+  entries = RAPTOR_CALLOC(raptor_qname_cache_entry*,
+                          RAPTOR_GOOD_CAST(size_t, new_size),
+                          sizeof(raptor_qname_cache_entry));
+  if(!entries)
+    return 1;
+
+  for(i = 0; i < cache->size; i++) {
+    raptor_qname_cache_entry* entry = &cache->entries[i];
+    unsigned int j;
+
+    if(!entry->name)
+      continue;
+
+    for(j = entry->hash & mask; entries[j].name; j = (j + 1) & mask)
+      ;
+    entries[j] = *entry;
+  }
+
+  RAPTOR_FREE(raptor_qname_cache_entry*, cache->entries);
+  cache->entries = entries;
+  cache->size = new_size;
+
+  return 0;
+}
+
+
+/**
+ * raptor_namespaces_enable_qname_cache:
+ * @nstack: namespace stack
+ *
+ * INTERNAL - Cache the URIs made by raptor_qname_string_to_uri()
+ *
+ * Return value: non-0 on failure
+ */
+int
+raptor_namespaces_enable_qname_cache(raptor_namespace_stack *nstack)
+{
+  if(nstack->qname_cache)
+    return 0;
+
+  nstack->qname_cache = raptor_new_qname_cache();
+
+  return !nstack->qname_cache;
+}
+
+
+/**
+ * raptor_namespaces_qname_cache_find:
+ * @nstack: namespace stack
+ * @name: qname string
+ * @name_len: length of @name
+ *
+ * INTERNAL - Find the URI for a qname string in the stack's qname cache
+ *
+ * Return value: new reference to the URI or NULL if not cached
+ */
+raptor_uri*
+raptor_namespaces_qname_cache_find(raptor_namespace_stack *nstack,
+                                   const unsigned char *name, size_t name_len)
+{
+  raptor_qname_cache* cache = nstack->qname_cache;
+  unsigned int mask;
+  unsigned int hash;
+  unsigned int i;
+
+  if(!cache || !cache->count)
+    return NULL;
+
+  mask = RAPTOR_GOOD_CAST(unsigned int, cache->size - 1);
+  hash = raptor_qname_cache_hash(name, name_len);
+
+  for(i = hash & mask; cache->entries[i].name; i = (i + 1) & mask) {
+    raptor_qname_cache_entry* entry = &cache->entries[i];
+
+    if(entry->hash == hash && entry->name_len == name_len &&
+       !memcmp(entry->name, name, name_len))
+      return raptor_uri_copy(entry->uri);
+  }
+
+  return NULL;
+}
+
+
+/**
+ * raptor_namespaces_qname_cache_add:
+ * @nstack: namespace stack
+ * @name: qname string
+ * @name_len: length of @name
+ * @uri: URI that @name expands to
+ *
+ * INTERNAL - Add the URI for a qname string to the stack's qname cache
+ *
+ * The cache takes a new reference to @uri.  Does nothing if the stack
+ * has no cache.
+ *
+ * Return value: non-0 on failure
+ */
+int
+raptor_namespaces_qname_cache_add(raptor_namespace_stack *nstack,
+                                  const unsigned char *name, size_t name_len,
+                                  raptor_uri* uri)
+{
+  raptor_qname_cache* cache = nstack->qname_cache;
+  raptor_qname_cache_entry* entry;
+  unsigned char* name_copy;
+  unsigned int mask;
+  unsigned int hash;
+  unsigned int i;
+
+  if(!cache)
+    return 0;
+
+  if(cache->count >= RAPTOR_QNAME_CACHE_MAX_COUNT)
+    raptor_qname_cache_clear(cache);
+
+  /* keep the table at most half full */
+  if((cache->count + 1) << 1 > cache->size && raptor_qname_cache_grow(cache))
+    return 1;
+
+  if(RAPTOR_SIZE_T_ADD_OVERFLOWS(name_len, 1))
+    return 1;
+  name_copy = RAPTOR_MALLOC(unsigned char*, name_len + 1);
+  if(!name_copy)
+    return 1;
+  memcpy(name_copy, name, name_len);
+  name_copy[name_len] = '\0';
+
+  mask = RAPTOR_GOOD_CAST(unsigned int, cache->size - 1);
+  hash = raptor_qname_cache_hash(name, name_len);
+  for(i = hash & mask; cache->entries[i].name; i = (i + 1) & mask)
+    ;
+
+  entry = &cache->entries[i];
+  entry->name = name_copy;
+  entry->name_len = name_len;
+  entry->hash = hash;
+  entry->uri = raptor_uri_copy(uri);
+  cache->count++;
+
+  return 0;
+}
+
+
 #define RAPTOR_NAMESPACES_HASHTABLE_SIZE 1024
 /**
  * raptor_namespaces_init:
@@ -148,6 +401,8 @@ raptor_namespaces_init(raptor_world* world,
 
   nstack->def_namespace = NULL;
 
+  nstack->qname_cache = NULL;
+
   nstack->rdf_ms_uri = raptor_new_uri_from_counted_string(nstack->world,
                                                           (const unsigned char*)raptor_rdf_namespace_uri,
                                                           raptor_rdf_namespace_uri_len);
@@ -243,6 +498,9 @@ raptor_namespaces_start_namespace(raptor_namespace_stack *nstack,
   if(!nstack->def_namespace)
     nstack->def_namespace = nspace;
 
+  if(nstack->qname_cache)
+    raptor_qname_cache_clear(nstack->qname_cache);
+
 #ifndef STANDALONE
 #ifdef RAPTOR_DEBUG_VERBOSE
     RAPTOR_DEBUG3("start namespace prefix %s depth %d\n", nspace->prefix ? (char*)nspace->prefix : "(default)", nspace->depth);
@@ -312,6 +570,11 @@ raptor_namespaces_clear(raptor_namespace_stack *nstack)
     nstack->table_size = 0;
   }
 
+  if(nstack->qname_cache) {
+    raptor_free_qname_cache(nstack->qname_cache);
+    nstack->qname_cache = NULL;
+  }
+
   if(nstack->world) {
     if(nstack->rdf_ms_uri) {
       raptor_free_uri(nstack->rdf_ms_uri);
@@ -358,6 +621,7 @@ void
 raptor_namespaces_end_for_depth(raptor_namespace_stack *nstack, int depth)
 {
   int bucket;
+  int ended = 0;
   for(bucket = 0; bucket < nstack->table_size; bucket++) {
     while(nstack->table[bucket] &&
           nstack->table[bucket]->depth == depth) {
@@ -374,8 +638,12 @@ raptor_namespaces_end_for_depth(raptor_namespace_stack *nstack, int depth)
       nstack->size--;
 
       nstack->table[bucket] = next_ns;
+      ended++;
     }
   }
+
+  if(ended && nstack->qname_cache)
+    raptor_qname_cache_clear(nstack->qname_cache);
 }
 
 
@@ -1098,6 +1366,8 @@ main(int argc, char *argv[])
   const char *program = raptor_basename(argv[0]);
   raptor_namespace_stack namespaces; /* static */
   raptor_namespace* ns;
+  raptor_uri* uri;
+  raptor_uri* cached_uri;
 
   world = raptor_new_world();
   if(!world || raptor_world_open(world))
@@ -1148,6 +1418,67 @@ main(int argc, char *argv[])
 
   raptor_namespaces_clear(&namespaces);
 
+
+  /* qname cache must follow prefix redefinitions */
+  raptor_namespaces_init(world, &namespaces, 0);
+  if(raptor_namespaces_enable_qname_cache(&namespaces)) {
+    fprintf(stderr, "%s: Failed to enable qname cache\n", program);
+    return(1);
+  }
+
+  raptor_namespaces_start_namespace_full(&namespaces,
+                                         (const unsigned char*)"ex",
+                                         (const unsigned char*)"http://example.org/ns1#",
+                                         0);
+
+  uri = raptor_qname_string_to_uri(&namespaces,
+                                   (const unsigned char*)"ex:a", 4);
+  cached_uri = raptor_namespaces_qname_cache_find(&namespaces,
+                                                  (const unsigned char*)"ex:a",
+                                                  4);
+  if(!uri || cached_uri != uri ||
+     strcmp((const char*)raptor_uri_as_string(uri),
+            "http://example.org/ns1#a")) {
+    fprintf(stderr, "%s: qname ex:a was not expanded and cached\n", program);
+    return(1);
+  }
+  raptor_free_uri(cached_uri);
+  raptor_free_uri(uri);
+
+  raptor_namespaces_start_namespace_full(&namespaces,
+                                         (const unsigned char*)"ex",
+                                         (const unsigned char*)"http://example.org/ns2#",
+                                         0);
+
+  if(raptor_namespaces_qname_cache_find(&namespaces,
+                                        (const unsigned char*)"ex:a", 4)) {
+    fprintf(stderr, "%s: qname cache not emptied by prefix redefinition\n",
+            program);
+    return(1);
+  }
+
+  uri = raptor_qname_string_to_uri(&namespaces,
+                                   (const unsigned char*)"ex:a", 4);
+  if(!uri ||
+     strcmp((const char*)raptor_uri_as_string(uri),
+            "http://example.org/ns2#a")) {
+    fprintf(stderr, "%s: qname ex:a expanded with old prefix binding\n",
+            program);
+    return(1);
+  }
+  raptor_free_uri(uri);
+
+  raptor_namespaces_end_for_depth(&namespaces, 0);
+
+  if(raptor_namespaces_qname_cache_find(&namespaces,
+                                        (const unsigned char*)"ex:a", 4)) {
+    fprintf(stderr, "%s: qname cache not emptied by namespace end\n",
+            program);
+    return(1);
+  }
+
+  raptor_namespaces_clear(&namespaces);
+
   raptor_free_world(world);
 
   /* keep gcc -Wall happy */
@@ -474,6 +474,7 @@ raptor_parse_turtle_term_internal(raptor_world* world,
 /*
  * raptor_ntriples_parse_term:
  * @world: raptor world
+ * @arena: arena to allocate the term from (or NULL)
  * @locator: raptor locator (in/out) (or NULL)
  * @string: string input (in)
  * @len_p: pointer to length of @string (in/out)
@@ -489,7 +490,8 @@ raptor_parse_turtle_term_internal(raptor_world* world,
  * Return value: number of bytes processed or 0 on failure
  */
 size_t
-raptor_ntriples_parse_term(raptor_world* world, raptor_locator* locator,
+raptor_ntriples_parse_term(raptor_world* world, raptor_arena* arena,
+                           raptor_locator* locator,
                            unsigned char *string, size_t *len_p,
                            raptor_term** term_p, int allow_turtle)
 {
@@ -536,7 +538,7 @@ raptor_ntriples_parse_term(raptor_world* world, raptor_locator* locator,
           goto fail;
         }
 
-        *term_p = raptor_new_term_from_uri(world, uri);
+        *term_p = raptor_new_term_from_uri_in_arena(arena, world, uri);
         raptor_free_uri(uri);
       }
       break;
@@ -565,10 +567,10 @@ raptor_ntriples_parse_term(raptor_world* world, raptor_locator* locator,
           goto fail;
         }
 
-        *term_p = raptor_new_term_from_literal(world,
-                                               dest,
+        *term_p = raptor_new_term_from_counted_literal_in_arena(arena, world,
+                                               dest, strlen((const char*)dest),
                                                datatype_uri,
-                                               NULL /* language */);
+                                               NULL /* language */, 0);
         raptor_free_uri(datatype_uri);
       } else
         goto fail;
@@ -593,6 +595,7 @@ raptor_ntriples_parse_term(raptor_world* world, raptor_locator* locator,
 
       if(1) {
         unsigned char *object_literal_language = NULL;
+        unsigned char object_literal_language_len = 0;
         unsigned char *object_literal_datatype = NULL;
         raptor_uri* datatype_uri = NULL;
 
@@ -681,10 +684,19 @@ raptor_ntriples_parse_term(raptor_world* world, raptor_locator* locator,
           object_literal_language = NULL;
         }
 
-        *term_p = raptor_new_term_from_literal(world,
-                                               dest,
+        if(object_literal_language) {
+          size_t language_len = strlen((const char*)object_literal_language);
+          /* longer than a term language can be */
+          if(language_len > 255)
+            goto fail;
+          object_literal_language_len = RAPTOR_GOOD_CAST(unsigned char, language_len);
+        }
+
+        *term_p = raptor_new_term_from_counted_literal_in_arena(arena, world,
+                                               dest, strlen((const char*)dest),
                                                datatype_uri,
-                                               object_literal_language);
+                                               object_literal_language,
+                                               object_literal_language_len);
         if(datatype_uri)
           raptor_free_uri(datatype_uri);
       }
@@ -730,7 +742,8 @@ raptor_ntriples_parse_term(raptor_world* world, raptor_locator* locator,
           goto fail;
         }
 
-        *term_p = raptor_new_term_from_blank(world, dest);
+        *term_p = raptor_new_term_from_counted_blank_in_arena(arena, world,
+                                                dest, strlen((const char*)dest));
 
         break;
 
@@ -296,6 +296,36 @@ static const struct
     RAPTOR_OPTION_VALUE_TYPE_BOOL,
     "loadExternalEntities",
     "Parsers and SAX2 should load external entities."
+  },
+  { RAPTOR_OPTION_PARSE_THREADS,
+    RAPTOR_OPTION_AREA_PARSER,
+    RAPTOR_OPTION_VALUE_TYPE_INT,
+    "parseThreads",
+    "Parsers use this number of worker threads where supported"
+  },
+  { RAPTOR_OPTION_PARSE_UNORDERED,
+    RAPTOR_OPTION_AREA_PARSER,
+    RAPTOR_OPTION_VALUE_TYPE_BOOL,
+    "parseUnordered",
+    "Parallel parsers may return statements out of document order"
+  },
+  { RAPTOR_OPTION_READ_BLOCK_SIZE,
+    RAPTOR_OPTION_AREA_PARSER,
+    RAPTOR_OPTION_VALUE_TYPE_INT,
+    "readBlockSize",
+    "Bytes read from a file or iostream per parse step"
+  },
+  { RAPTOR_OPTION_READ_BLOCK_ADAPTIVE,
+    RAPTOR_OPTION_AREA_PARSER,
+    RAPTOR_OPTION_VALUE_TYPE_BOOL,
+    "readBlockAdaptive",
+    "Grow the read block size for long inputs"
+  },
+  { RAPTOR_OPTION_PARSE_ARENA,
+    RAPTOR_OPTION_AREA_PARSER,
+    RAPTOR_OPTION_VALUE_TYPE_BOOL,
+    "parseArena",
+    "Allocate parsed terms from a per-statement arena"
   }
 };
 
@@ -43,6 +43,10 @@
 #ifdef HAVE_FCNTL_H
 #include <fcntl.h>
 #endif
+#if defined(HAVE_MMAP) && defined(HAVE_SYS_MMAN_H) && defined(HAVE_SYS_STAT_H)
+#include <sys/mman.h>
+#define RAPTOR_PARSE_FILE_MMAP 1
+#endif
 
 /* Raptor includes */
 #include "raptor2.h"
@@ -448,6 +452,9 @@ raptor_parser_parse_start(raptor_parser *rdf_parser, raptor_uri *uri)
   rdf_parser->error_count = 0;
   rdf_parser->warning_count = 0;
 
+  /* return statements left from an unfinished parse */
+  raptor_parser_flush_statements(rdf_parser);
+
   rdf_parser->locator.uri    = uri;
   rdf_parser->locator.line   = -1;
   rdf_parser->locator.column = -1;
@@ -480,10 +487,17 @@ int
 raptor_parser_parse_chunk(raptor_parser* rdf_parser,
                           const unsigned char *buffer, size_t len, int is_end) 
 {
+  int rc;
+
   if(rdf_parser->sb)
     raptor_stringbuffer_append_counted_string(rdf_parser->sb, buffer, len, 1);
     
-  return rdf_parser->factory->chunk(rdf_parser, buffer, len, is_end);
+  rc = rdf_parser->factory->chunk(rdf_parser, buffer, len, is_end);
+
+  if(is_end)
+    raptor_parser_flush_statements(rdf_parser);
+
+  return rc;
 }
 
 
@@ -515,12 +529,147 @@ raptor_free_parser(raptor_parser* rdf_parser)
   if(rdf_parser->sb)
     raptor_free_stringbuffer(rdf_parser->sb);
 
+  if(rdf_parser->read_buffer)
+    RAPTOR_FREE(char*, rdf_parser->read_buffer);
+
+  if(rdf_parser->statement_batch) {
+    /* discard any statements from an unfinished parse */
+    int i;
+    for(i = 0; i < rdf_parser->statement_batch_count; i++)
+      raptor_statement_clear(&rdf_parser->statement_batch[i]);
+    RAPTOR_FREE(raptor_statement*, rdf_parser->statement_batch);
+  }
+
+  if(rdf_parser->arena)
+    raptor_free_arena(rdf_parser->arena);
+
   raptor_object_options_clear(&rdf_parser->options);
 
   RAPTOR_FREE(raptor_parser, rdf_parser);
 }
 
 
+/*
+ * raptor_parser_start_arena:
+ * @rdf_parser: parser
+ *
+ * INTERNAL - Create or free the parser arena for a new parse
+ *
+ * For parsers that support #RAPTOR_OPTION_PARSE_ARENA, to call from
+ * their start method.  Afterwards @rdf_parser->arena is the arena to
+ * allocate the terms of a statement from, or NULL if the option is
+ * not set.  The arena is kept between parses.
+ *
+ * Return value: non-0 on failure
+ */
+int
+raptor_parser_start_arena(raptor_parser* rdf_parser)
+{
+  if(!RAPTOR_OPTIONS_GET_NUMERIC(rdf_parser, RAPTOR_OPTION_PARSE_ARENA)) {
+    if(rdf_parser->arena) {
+      raptor_free_arena(rdf_parser->arena);
+      rdf_parser->arena = NULL;
+    }
+    return 0;
+  }
+
+  if(!rdf_parser->arena) {
+    rdf_parser->arena = raptor_new_arena(0);
+    if(!rdf_parser->arena) {
+      raptor_parser_fatal_error(rdf_parser, "Out of memory");
+      return 1;
+    }
+  } else
+    raptor_arena_reset(rdf_parser->arena);
+
+  return 0;
+}
+
+
+/*
+ * raptor_parser_get_read_block_size:
+ * @rdf_parser: parser
+ *
+ * INTERNAL - Get the size of the first block to read from the options
+ *
+ * Return value: block size in bytes
+ */
+static size_t
+raptor_parser_get_read_block_size(raptor_parser* rdf_parser)
+{
+  int size;
+
+  size = RAPTOR_OPTIONS_GET_NUMERIC(rdf_parser, RAPTOR_OPTION_READ_BLOCK_SIZE);
+  if(size <= 0)
+    return RAPTOR_READ_BUFFER_SIZE;
+
+  if(size > RAPTOR_READ_BLOCK_MAX_SIZE)
+    size = RAPTOR_READ_BLOCK_MAX_SIZE;
+
+  return RAPTOR_GOOD_CAST(size_t, size);
+}
+
+
+/*
+ * raptor_parser_next_read_block_size:
+ * @rdf_parser: parser
+ * @size: size of the block just read in full
+ *
+ * INTERNAL - Get the size of the next block to read
+ *
+ * In adaptive mode the block size doubles after each full block read
+ * so a long input is passed to the parser in fewer, larger chunks.
+ *
+ * Return value: block size in bytes
+ */
+static size_t
+raptor_parser_next_read_block_size(raptor_parser* rdf_parser, size_t size)
+{
+  if(!RAPTOR_OPTIONS_GET_NUMERIC(rdf_parser, RAPTOR_OPTION_READ_BLOCK_ADAPTIVE) ||
+     size >= RAPTOR_READ_BLOCK_ADAPTIVE_MAX_SIZE)
+    return size;
+
+  size <<= 1;
+  if(size > RAPTOR_READ_BLOCK_ADAPTIVE_MAX_SIZE)
+    size = RAPTOR_READ_BLOCK_ADAPTIVE_MAX_SIZE;
+
+  return size;
+}
+
+
+/*
+ * raptor_parser_get_read_buffer:
+ * @rdf_parser: parser
+ * @size: block size
+ *
+ * INTERNAL - Get a read buffer with room for @size bytes and a NUL
+ *
+ * Return value: buffer or NULL on failure
+ */
+static unsigned char*
+raptor_parser_get_read_buffer(raptor_parser* rdf_parser, size_t size)
+{
+  if(size <= RAPTOR_READ_BUFFER_SIZE)
+    return rdf_parser->buffer;
+
+  if(size > rdf_parser->read_buffer_size) {
+    /* the old contents are never needed */
+    if(rdf_parser->read_buffer)
+      RAPTOR_FREE(char*, rdf_parser->read_buffer);
+    rdf_parser->read_buffer_size = 0;
+
+    rdf_parser->read_buffer = RAPTOR_MALLOC(unsigned char*, size + 1);
+    if(!rdf_parser->read_buffer) {
+      raptor_parser_fatal_error(rdf_parser, "Out of memory");
+      return NULL;
+    }
+    rdf_parser->read_buffer_size = size;
+  }
+
+  return rdf_parser->read_buffer;
+}
+
+
 /**
  * raptor_parser_parse_file_stream:
  * @rdf_parser: parser
@@ -530,6 +679,9 @@ raptor_free_parser(raptor_parser* rdf_parser)
  *
  * Parse RDF content from a FILE*.
  *
+ * The content is read in blocks set by #RAPTOR_OPTION_READ_BLOCK_SIZE
+ * and #RAPTOR_OPTION_READ_BLOCK_ADAPTIVE.
+ *
  * After draining the FILE* stream (EOF), fclose is not called on it.
  *
  * Return value: non 0 on failure
@@ -541,6 +693,7 @@ raptor_parser_parse_file_stream(raptor_parser* rdf_parser,
 {
   int rc = 0;
   raptor_locator *locator = &rdf_parser->locator;
+  size_t block_size;
 
   if(!stream || !base_uri)
     return 1;
@@ -551,19 +704,114 @@ raptor_parser_parse_file_stream(raptor_parser* rdf_parser,
   if(raptor_parser_parse_start(rdf_parser, base_uri))
     return 1;
   
+  block_size = raptor_parser_get_read_block_size(rdf_parser);
   while(!feof(stream)) {
-    size_t len = fread(rdf_parser->buffer, 1, RAPTOR_READ_BUFFER_SIZE, stream);
-    int is_end = (len < RAPTOR_READ_BUFFER_SIZE);
-    rdf_parser->buffer[len] = '\0';
-    rc = raptor_parser_parse_chunk(rdf_parser, rdf_parser->buffer, len, is_end);
+    unsigned char* buffer;
+    size_t len;
+    int is_end;
+
+    buffer = raptor_parser_get_read_buffer(rdf_parser, block_size);
+    if(!buffer) {
+      rc = 1;
+      break;
+    }
+
+    len = fread(buffer, 1, block_size, stream);
+    is_end = (len < block_size);
+    buffer[len] = '\0';
+    rc = raptor_parser_parse_chunk(rdf_parser, buffer, len, is_end);
     if(rc || is_end)
       break;
+
+    block_size = raptor_parser_next_read_block_size(rdf_parser, block_size);
   }
 
   return (rc != 0);
 }
 
 
+#ifdef RAPTOR_PARSE_FILE_MMAP
+/* Bytes of a mapped file given to the parser in each chunk */
+#define RAPTOR_MMAP_WINDOW_SIZE (1 << 20)
+
+/*
+ * raptor_parser_parse_file_mmap:
+ * @rdf_parser: parser
+ * @stream: FILE* of a file opened for reading
+ * @filename: filename of content
+ * @base_uri: the base URI to use
+ * @rc_p: pointer to store the parse result
+ *
+ * INTERNAL - Parse RDF content from a regular file mapped into memory
+ *
+ * The parser is given large windows of the mapped pages directly
+ * instead of copies read into the parser buffer.  Pipes, devices,
+ * empty files and files that cannot be mapped are not handled here.
+ *
+ * Return value: non 0 if the file was not parsed and must be read instead
+ */
+static int
+raptor_parser_parse_file_mmap(raptor_parser* rdf_parser, FILE *stream,
+                              const char* filename, raptor_uri *base_uri,
+                              int* rc_p)
+{
+  raptor_locator *locator = &rdf_parser->locator;
+  struct stat buf;
+  unsigned char* map;
+  size_t size;
+  size_t offset;
+  size_t window_size = RAPTOR_MMAP_WINDOW_SIZE;
+  int fd = fileno(stream);
+  int rc = 0;
+
+  if(fd < 0 || fstat(fd, &buf) || !S_ISREG(buf.st_mode) || buf.st_size <= 0)
+    return 1;
+
+  size = RAPTOR_GOOD_CAST(size_t, buf.st_size);
+  /* larger than the address space */
+  if(RAPTOR_GOOD_CAST(off_t, size) != buf.st_size)
+    return 1;
+
+  map = (unsigned char*)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if(map == (unsigned char*)MAP_FAILED)
+    return 1;
+
+#ifdef HAVE_MADVISE
+  /* read ahead aggressively and drop pages once they are passed */
+  (void)madvise(map, size, MADV_SEQUENTIAL);
+#endif
+
+  locator->line= locator->column = -1;
+  locator->file= filename;
+
+  /* a block size set explicitly is used for the windows too */
+  if(RAPTOR_OPTIONS_GET_NUMERIC(rdf_parser, RAPTOR_OPTION_READ_BLOCK_SIZE) > 0)
+    window_size = raptor_parser_get_read_block_size(rdf_parser);
+
+  if(raptor_parser_parse_start(rdf_parser, base_uri))
+    rc = 1;
+  else {
+    for(offset = 0; offset < size; ) {
+      size_t len = size - offset;
+      if(len > window_size)
+        len = window_size;
+
+      rc = raptor_parser_parse_chunk(rdf_parser, map + offset, len,
+                                     (offset + len == size));
+      if(rc)
+        break;
+      offset += len;
+    }
+  }
+
+  munmap(map, size);
+
+  *rc_p = (rc != 0);
+  return 0;
+}
+#endif
+
+
 /**
  * raptor_parser_parse_file:
  * @rdf_parser: parser
@@ -574,6 +822,10 @@ raptor_parser_parse_file_stream(raptor_parser* rdf_parser,
  *
  * If @uri is NULL (source is stdin), then the @base_uri is required.
  *
+ * Where the system supports it, a regular file is mapped into memory
+ * and passed to the parser without copying; other files are read.
+ * The file must not be truncated while it is being parsed.
+ *
  * The return value reflects only fatal-stop conditions: a parser can
  * report recoverable (error-level) problems and still return 0, since
  * only a fatal error halts parsing.  To detect such errors, either
@@ -625,6 +877,12 @@ raptor_parser_parse_file(raptor_parser* rdf_parser, raptor_uri *uri,
     fh = stdin;
   }
 
+#ifdef RAPTOR_PARSE_FILE_MMAP
+  if(uri &&
+     !raptor_parser_parse_file_mmap(rdf_parser, fh, filename, base_uri, &rc))
+    goto cleanup;
+#endif
+
   rc = raptor_parser_parse_file_stream(rdf_parser, fh, filename, base_uri);
 
   cleanup:
@@ -987,11 +1245,135 @@ raptor_parser_set_statement_handler(raptor_parser* parser,
                                     void *user_data,
                                     raptor_statement_handler handler)
 {
+  /* replaces any batch handler */
+  raptor_parser_flush_statements(parser);
+  parser->statement_batch_handler = NULL;
+
   parser->user_data = user_data;
   parser->statement_handler = handler;
 }
 
 
+/**
+ * raptor_parser_set_statement_batch_handler:
+ * @parser: #raptor_parser parser object
+ * @user_data: user data pointer for callback
+ * @handler: new statement batch callback function
+ * @batch_size: maximum number of statements in a batch or <= 0 for the default (1024)
+ *
+ * Set the statement batch handler function for the parser.
+ *
+ * Use this instead of raptor_parser_set_statement_handler() to
+ * receive the statements as arrays of up to @batch_size statements,
+ * such as to insert them into a store in bulk.  A batch is passed to
+ * @handler when it is full, before a graph mark is returned by the
+ * #raptor_graph_mark_handler and at the end of the parse, so that
+ * statements and graph marks keep their order.
+ *
+ * The statements in the array and their terms are only valid during
+ * the handler call and must be copied by the caller with
+ * raptor_statement_copy() to be kept.
+ *
+ * Setting a batch handler replaces any statement handler and setting
+ * a statement handler replaces any batch handler.
+ **/
+void
+raptor_parser_set_statement_batch_handler(raptor_parser* parser,
+                                          void *user_data,
+                                          raptor_statement_batch_handler handler,
+                                          int batch_size)
+{
+  /* return statements pending for the old handler */
+  raptor_parser_flush_statements(parser);
+
+  if(batch_size <= 0)
+    batch_size = RAPTOR_STATEMENT_BATCH_DEFAULT_SIZE;
+
+  if(parser->statement_batch && parser->statement_batch_size != batch_size) {
+    RAPTOR_FREE(raptor_statement*, parser->statement_batch);
+    parser->statement_batch = NULL;
+  }
+  parser->statement_batch_size = batch_size;
+
+  parser->user_data = user_data;
+  parser->statement_handler = NULL;
+  parser->statement_batch_handler = handler;
+}
+
+
+/*
+ * raptor_parser_emit_statement:
+ * @parser: parser
+ * @statement: statement
+ *
+ * INTERNAL - Return a statement to the statement handler or batch handler
+ *
+ * Parsers call this for every statement they generate.  The
+ * @statement is not kept: with a batch handler the statement is added
+ * to the pending batch with copies of its terms.
+ */
+void
+raptor_parser_emit_statement(raptor_parser* parser,
+                             raptor_statement* statement)
+{
+  raptor_statement* s;
+
+  if(parser->statement_handler) {
+    (*parser->statement_handler)(parser->user_data, statement);
+    return;
+  }
+
+  if(!parser->statement_batch_handler)
+    return;
+
+  if(!parser->statement_batch) {
+    parser->statement_batch = RAPTOR_CALLOC(raptor_statement*,
+                                            RAPTOR_GOOD_CAST(size_t, parser->statement_batch_size),
+                                            sizeof(raptor_statement));
+    if(!parser->statement_batch) {
+      raptor_parser_fatal_error(parser, "Out of memory");
+      return;
+    }
+  }
+
+  s = &parser->statement_batch[parser->statement_batch_count++];
+  raptor_statement_init(s, parser->world);
+  s->subject = raptor_term_copy(statement->subject);
+  s->predicate = raptor_term_copy(statement->predicate);
+  s->object = raptor_term_copy(statement->object);
+  s->graph = raptor_term_copy(statement->graph);
+
+  if(parser->statement_batch_count == parser->statement_batch_size)
+    raptor_parser_flush_statements(parser);
+}
+
+
+/*
+ * raptor_parser_flush_statements:
+ * @parser: parser
+ *
+ * INTERNAL - Return any pending statements to the batch handler
+ */
+void
+raptor_parser_flush_statements(raptor_parser* parser)
+{
+  int count = parser->statement_batch_count;
+  int i;
+
+  if(!count)
+    return;
+
+  parser->statement_batch_count = 0;
+
+  if(parser->statement_batch_handler)
+    (*parser->statement_batch_handler)(parser->user_data,
+                                       parser->statement_batch, count);
+
+  for(i = 0; i < count; i++)
+    raptor_statement_clear(&parser->statement_batch[i]);
+}
+
+
 /**
  * raptor_parser_set_graph_mark_handler:
  * @parser: #raptor_parser parser object
@@ -1419,26 +1801,15 @@ raptor_world_guess_parser_name(raptor_world* world,
     }
     
     if(factory->recognise_syntax) {
-      int c = -1;
-    
       /* Only use first N bytes to avoid HTML documents that contain
-       * RDF/XML examples
+       * RDF/XML examples.  The buffer may be read-only (a mapped file)
+       * so it is shortened rather than NUL terminated.
        */
 #define FIRSTN 1024
-#if FIRSTN > RAPTOR_READ_BUFFER_SIZE
-#error "RAPTOR_READ_BUFFER_SIZE is not large enough"
-#endif
-      if(buffer && len && len > FIRSTN) {
-        c = buffer[FIRSTN];
-        ((char*)buffer)[FIRSTN] = '\0';
-      }
-
-      score += factory->recognise_syntax(factory, buffer, len, 
+      score += factory->recognise_syntax(factory, buffer,
+                                         (len > FIRSTN) ? FIRSTN : len,
                                          identifier, suffix, 
                                          mime_type);
-
-      if(c >= 0)
-        ((char*)buffer)[FIRSTN] = RAPTOR_GOOD_CAST(char, c);
     }
 
     scores[i].score = score < 10 ? score : 10; 
@@ -1502,6 +1873,8 @@ raptor_parser_copy_user_state(raptor_parser *to_parser,
   
   to_parser->user_data = from_parser->user_data;
   to_parser->statement_handler = from_parser->statement_handler;
+  to_parser->statement_batch_handler = from_parser->statement_batch_handler;
+  to_parser->statement_batch_size = from_parser->statement_batch_size;
   to_parser->namespace_handler = from_parser->namespace_handler;
   to_parser->namespace_handler_user_data = from_parser->namespace_handler_user_data;
   to_parser->uri_filter = from_parser->uri_filter;
@@ -1718,6 +2091,9 @@ raptor_parser_start_graph(raptor_parser* parser, raptor_uri* uri,
 
   if(!parser->emit_graph_marks)
     return;
+
+  /* statements before the mark are returned before it */
+  raptor_parser_flush_statements(parser);
   
   if(parser->graph_mark_handler)
     (*parser->graph_mark_handler)(parser->user_data, uri, flags);
@@ -1733,6 +2109,9 @@ raptor_parser_end_graph(raptor_parser* parser, raptor_uri* uri, int is_declared)
   
   if(!parser->emit_graph_marks)
     return;
+
+  /* statements before the mark are returned before it */
+  raptor_parser_flush_statements(parser);
   
   if(parser->graph_mark_handler)
     (*parser->graph_mark_handler)(parser->user_data, uri, flags);
@@ -1792,6 +2171,7 @@ raptor_parser_parse_iostream(raptor_parser* rdf_parser, raptor_iostream *iostr,
                              raptor_uri *base_uri)
 {
   int rc = 0;
+  size_t block_size;
 
   RAPTOR_ASSERT_OBJECT_POINTER_RETURN_VALUE(rdf_parser, raptor_parser, 1);
   RAPTOR_ASSERT_OBJECT_POINTER_RETURN_VALUE(iostr, raptor_iostr, 1);
@@ -1800,21 +2180,30 @@ raptor_parser_parse_iostream(raptor_parser* rdf_parser, raptor_iostream *iostr,
   if(rc)
     return rc;
   
+  block_size = raptor_parser_get_read_block_size(rdf_parser);
   while(!raptor_iostream_read_eof(iostr)) {
+    unsigned char* buffer;
     int ilen;
     size_t len;
     int is_end;
 
-    ilen = raptor_iostream_read_bytes(rdf_parser->buffer, 1,
-                                      RAPTOR_READ_BUFFER_SIZE, iostr);
+    buffer = raptor_parser_get_read_buffer(rdf_parser, block_size);
+    if(!buffer) {
+      rc = 1;
+      break;
+    }
+
+    ilen = raptor_iostream_read_bytes(buffer, 1, block_size, iostr);
     if(ilen < 0)
       break;
     len = RAPTOR_GOOD_CAST(size_t, ilen);
-    is_end = (len < RAPTOR_READ_BUFFER_SIZE);
+    is_end = (len < block_size);
 
-    rc = raptor_parser_parse_chunk(rdf_parser, rdf_parser->buffer, len, is_end);
+    rc = raptor_parser_parse_chunk(rdf_parser, buffer, len, is_end);
     if(rc || is_end)
       break;
+
+    block_size = raptor_parser_next_read_block_size(rdf_parser, block_size);
   }
   
   return rc;
@@ -1839,6 +2228,95 @@ raptor_parse_test_silent_log_handler(void *user_data,
 }
 
 
+static void
+raptor_parse_test_count_statement_handler(void *user_data,
+                                          raptor_statement *statement)
+{
+  int* count_p = (int*)user_data;
+  (*count_p)++;
+}
+
+
+static void
+raptor_parse_test_string_statement_handler(void *user_data,
+                                           raptor_statement *statement)
+{
+  raptor_stringbuffer* sb = (raptor_stringbuffer*)user_data;
+  raptor_term* terms[3];
+  int i;
+
+  terms[0] = statement->subject;
+  terms[1] = statement->predicate;
+  terms[2] = statement->object;
+  for(i = 0; i < 3; i++) {
+    unsigned char* s = raptor_term_to_string(terms[i]);
+    if(s) {
+      raptor_stringbuffer_append_string(sb, s, 1);
+      raptor_free_memory(s);
+    }
+    raptor_stringbuffer_append_counted_string(sb,
+                                              (const unsigned char*)" ", 1, 1);
+  }
+  raptor_stringbuffer_append_counted_string(sb,
+                                            (const unsigned char*)"\n", 1, 1);
+}
+
+
+#define PARSE_TEST_BATCH_SIZE 7
+
+static void
+raptor_parse_test_string_statement_batch_handler(void *user_data,
+                                                 raptor_statement *statements,
+                                                 int count)
+{
+  raptor_stringbuffer* sb = (raptor_stringbuffer*)user_data;
+  int i;
+
+  if(count < 1 || count > PARSE_TEST_BATCH_SIZE)
+    /* make the comparison with the expected statements fail */
+    raptor_stringbuffer_append_string(sb, (const unsigned char*)"BAD BATCH\n",
+                                      1);
+
+  for(i = 0; i < count; i++)
+    raptor_parse_test_string_statement_handler(user_data, &statements[i]);
+}
+
+
+/* parse @doc in @chunk_size pieces returning the statements as a
+ * string, using a batch handler if @batch is non-0 */
+static raptor_stringbuffer*
+raptor_parse_test_parse_doc(raptor_parser* parser, raptor_uri* base_uri,
+                            const unsigned char* doc, size_t doc_len,
+                            size_t chunk_size, int batch)
+{
+  raptor_stringbuffer* sb;
+  size_t offset;
+
+  sb = raptor_new_stringbuffer();
+  if(!sb)
+    return NULL;
+
+  if(batch)
+    raptor_parser_set_statement_batch_handler(parser, sb,
+                                              raptor_parse_test_string_statement_batch_handler,
+                                              PARSE_TEST_BATCH_SIZE);
+  else
+    raptor_parser_set_statement_handler(parser, sb,
+                                        raptor_parse_test_string_statement_handler);
+  raptor_parser_parse_start(parser, base_uri);
+  for(offset = 0; offset < doc_len; offset += chunk_size) {
+    size_t len = doc_len - offset;
+    if(len > chunk_size)
+      len = chunk_size;
+    if(raptor_parser_parse_chunk(parser, doc + offset, len, 0))
+      break;
+  }
+  raptor_parser_parse_chunk(parser, NULL, 0, 1);
+
+  return sb;
+}
+
+
 int
 main(int argc, char *argv[])
 {
@@ -1959,6 +2437,300 @@ main(int argc, char *argv[])
     raptor_free_parser(parser);
   }
 
+  /* check N-Triples lines split across every possible chunk boundary,
+   * including CR LF pairs, quoted newlines and a line longer than the
+   * initial input window */
+  if(raptor_world_is_parser_name(world, "ntriples")) {
+#define PARSE_TEST_LONG_LITERAL_LEN 10000
+    raptor_parser* parser;
+    raptor_uri* base_uri;
+    const char* doc_start =
+      "<http://example.org/s> <http://example.org/p> \"a\\\"b\" .\r\n"
+      "\r\n"
+      "# comment \"with\" <quotes>\r"
+      "<http://example.org/s> <http://example.org/p> \"x\\ny\"@en .\n"
+      "_:b1 <http://example.org/p> \"";
+    const char* doc_end = "\" .\r\n"
+      "<http://example.org/s> <http://example.org/p> <http://example.org/o> .";
+    unsigned char* doc;
+    size_t doc_len;
+    size_t start_len = strlen(doc_start);
+    size_t end_len = strlen(doc_end);
+    size_t chunk_size;
+    int count;
+
+    doc_len = start_len + PARSE_TEST_LONG_LITERAL_LEN + end_len;
+    doc = RAPTOR_MALLOC(unsigned char*, doc_len + 1);
+    if(!doc)
+      return 1;
+    memcpy(doc, doc_start, start_len);
+    memset(doc + start_len, 'z', PARSE_TEST_LONG_LITERAL_LEN);
+    memcpy(doc + start_len + PARSE_TEST_LONG_LITERAL_LEN, doc_end, end_len);
+    doc[doc_len] = '\0';
+
+    parser = raptor_new_parser(world, "ntriples");
+    if(!parser) {
+      fprintf(stderr, "%s: raptor_new_parser(ntriples) failed\n", program);
+      return 1;
+    }
+    raptor_parser_set_statement_handler(parser, &count,
+                                        raptor_parse_test_count_statement_handler);
+
+    base_uri = raptor_new_uri(world,
+                              (const unsigned char*)"http://example.org/base");
+
+    for(chunk_size = 1; chunk_size <= 7; chunk_size++) {
+      size_t offset;
+
+      count = 0;
+      raptor_parser_parse_start(parser, base_uri);
+      for(offset = 0; offset < doc_len; offset += chunk_size) {
+        size_t len = doc_len - offset;
+        if(len > chunk_size)
+          len = chunk_size;
+        if(raptor_parser_parse_chunk(parser, doc + offset, len, 0))
+          break;
+      }
+      raptor_parser_parse_chunk(parser, NULL, 0, 1);
+
+      if(count != 4 || raptor_parser_get_error_count(parser) != 0) {
+        fprintf(stderr,
+                "%s: N-Triples in %d byte chunks returned %d triples with %d errors; expected 4, 0\n",
+                program, (int)chunk_size, count,
+                raptor_parser_get_error_count(parser));
+        return 1;
+      }
+    }
+
+    raptor_free_uri(base_uri);
+    raptor_free_parser(parser);
+    RAPTOR_FREE(char*, doc);
+  }
+
+  /* check parsing N-Triples with worker threads, an arena or a batch
+   * handler returns the same statements as parsing serially one at a
+   * time, in order unless unordered */
+  if(raptor_world_is_parser_name(world, "ntriples")) {
+#define PARSE_TEST_THREADS_LINES 20000
+    raptor_parser* parser;
+    raptor_uri* base_uri;
+    raptor_stringbuffer* doc_sb;
+    raptor_stringbuffer* serial_sb = NULL;
+    raptor_stringbuffer* threaded_sb = NULL;
+    const unsigned char* doc;
+    size_t doc_len;
+    int mode;
+    int rc = 0;
+
+    doc_sb = raptor_new_stringbuffer();
+    if(!doc_sb)
+      return 1;
+    for(i = 0; i < PARSE_TEST_THREADS_LINES; i++) {
+      char line[200];
+
+      switch(i % 8) {
+        case 0:
+          sprintf(line, "<http://example.org/s%d> <http://example.org/p> \"plain\\t%d\" .\n", i, i);
+          break;
+        case 1:
+          sprintf(line, "_:b%d <http://example.org/p> \"caf\\u00E9 \xe2\x82\xac%d\"@fr-CA .\n", i % 10, i);
+          break;
+        case 2:
+          sprintf(line, "<http://example.org/s> <http://example.org/p> \"%d\"^^<http://www.w3.org/2001/XMLSchema#integer> .\n", i);
+          break;
+        case 3:
+          sprintf(line, "# comment %d\n\n", i);
+          break;
+        case 4:
+          sprintf(line, "  <http://example.org/\xc3\xa9%d>\t<http://example.org/p> _:o%d . # trailing\r\n", i, i);
+          break;
+        case 5:
+          /* parsed serially: an escape in an IRI */
+          sprintf(line, "<http://example.org/\\u00E9%d> <http://example.org/p> <http://example.org/o> .\n", i);
+          break;
+        case 6:
+          /* parsed serially: an ordinal predicate */
+          sprintf(line, "<http://example.org/s> <http://www.w3.org/1999/02/22-rdf-syntax-ns#_%d> \"\\U0001F600\" .\n", i);
+          break;
+        default:
+          sprintf(line, "_:x.y%d <http://example.org/p> \"quote \\\" in %d\" .\n", i, i);
+          break;
+      }
+      raptor_stringbuffer_append_string(doc_sb, (const unsigned char*)line, 1);
+    }
+    doc = raptor_stringbuffer_as_string(doc_sb);
+    doc_len = raptor_stringbuffer_length(doc_sb);
+
+    parser = raptor_new_parser(world, "ntriples");
+    if(!parser) {
+      fprintf(stderr, "%s: raptor_new_parser(ntriples) failed\n", program);
+      return 1;
+    }
+    base_uri = raptor_new_uri(world,
+                              (const unsigned char*)"http://example.org/base");
+
+    serial_sb = raptor_parse_test_parse_doc(parser, base_uri, doc, doc_len,
+                                            10000, 0);
+    if(!serial_sb || raptor_parser_get_error_count(parser) != 0) {
+      fprintf(stderr, "%s: serial N-Triples parse failed\n", program);
+      return 1;
+    }
+
+    /* 0: threads; 1: threads, unordered; 2: arena; 3: threads and arena;
+     * 4: batches; 5: batches, threads and arena */
+    for(mode = 0; mode < 6 && !rc; mode++) {
+      int unordered = (mode == 1);
+
+      raptor_parser_set_option(parser, RAPTOR_OPTION_PARSE_THREADS, NULL,
+                               (mode == 2 || mode == 4) ? 0 : 4);
+      raptor_parser_set_option(parser, RAPTOR_OPTION_PARSE_UNORDERED, NULL,
+                               unordered);
+      raptor_parser_set_option(parser, RAPTOR_OPTION_PARSE_ARENA, NULL,
+                               (mode == 2 || mode == 3 || mode == 5));
+
+      threaded_sb = raptor_parse_test_parse_doc(parser, base_uri, doc, doc_len,
+                                                777, (mode >= 4));
+      if(!threaded_sb || raptor_parser_get_error_count(parser) != 0) {
+        fprintf(stderr, "%s: mode %d N-Triples parse failed\n", program, mode);
+        rc = 1;
+      } else if(raptor_stringbuffer_length(threaded_sb) !=
+                raptor_stringbuffer_length(serial_sb)) {
+        fprintf(stderr,
+                "%s: mode %d N-Triples parse returned %d bytes of statements, expected %d\n",
+                program, mode, (int)raptor_stringbuffer_length(threaded_sb),
+                (int)raptor_stringbuffer_length(serial_sb));
+        rc = 1;
+      } else if(!unordered &&
+                strcmp((const char*)raptor_stringbuffer_as_string(threaded_sb),
+                       (const char*)raptor_stringbuffer_as_string(serial_sb))) {
+        fprintf(stderr,
+                "%s: mode %d N-Triples parse returned different statements\n",
+                program, mode);
+        rc = 1;
+      }
+
+      if(threaded_sb)
+        raptor_free_stringbuffer(threaded_sb);
+    }
+
+    raptor_free_stringbuffer(serial_sb);
+    raptor_free_stringbuffer(doc_sb);
+    raptor_free_uri(base_uri);
+    raptor_free_parser(parser);
+    if(rc)
+      return rc;
+  }
+
+  /* check a file parsed from memory in windows returns the same
+   * statements as one read through a FILE* */
+  if(raptor_world_is_parser_name(world, "ntriples")) {
+#define PARSE_TEST_FILENAME "parse_test.nt"
+#define PARSE_TEST_FILE_LINES 50000
+    raptor_parser* parser;
+    raptor_uri* base_uri;
+    raptor_uri* file_uri;
+    unsigned char* file_uri_string;
+    FILE* fh;
+    int file_count = 0;
+    int stream_count = 0;
+
+    fh = fopen(PARSE_TEST_FILENAME, "wb");
+    if(!fh) {
+      fprintf(stderr, "%s: cannot create %s\n", program, PARSE_TEST_FILENAME);
+      return 1;
+    }
+    for(i = 0; i < PARSE_TEST_FILE_LINES; i++)
+      fprintf(fh, "<http://example.org/s%d> <http://example.org/p> \"%d\" .\n",
+              i, i);
+    /* no final newline */
+    fputs("<http://example.org/s> <http://example.org/p> \"end\" .", fh);
+    fclose(fh);
+
+    file_uri_string = raptor_uri_filename_to_uri_string(PARSE_TEST_FILENAME);
+    file_uri = raptor_new_uri(world, file_uri_string);
+    raptor_free_memory(file_uri_string);
+    base_uri = raptor_new_uri(world,
+                              (const unsigned char*)"http://example.org/base");
+
+    parser = raptor_new_parser(world, "ntriples");
+    if(!parser || !file_uri) {
+      fprintf(stderr, "%s: raptor_new_parser(ntriples) failed\n", program);
+      return 1;
+    }
+
+    raptor_parser_set_statement_handler(parser, &file_count,
+                                        raptor_parse_test_count_statement_handler);
+    if(raptor_parser_parse_file(parser, file_uri, base_uri))
+      file_count = -1;
+
+    fh = fopen(PARSE_TEST_FILENAME, "rb");
+    raptor_parser_set_statement_handler(parser, &stream_count,
+                                        raptor_parse_test_count_statement_handler);
+    if(!fh ||
+       raptor_parser_parse_file_stream(parser, fh, PARSE_TEST_FILENAME,
+                                       base_uri))
+      stream_count = -1;
+    if(fh)
+      fclose(fh);
+
+    /* small, large and adaptive read block sizes from an iostream */
+    for(i = 0; i < 4; i++) {
+      static const int block_sizes[4] = { 7, 100, 100, 5000000 };
+      raptor_iostream* iostr;
+      int iostr_count = 0;
+
+      raptor_parser_set_option(parser, RAPTOR_OPTION_READ_BLOCK_SIZE, NULL,
+                               block_sizes[i]);
+      raptor_parser_set_option(parser, RAPTOR_OPTION_READ_BLOCK_ADAPTIVE, NULL,
+                               (i == 2));
+      raptor_parser_set_statement_handler(parser, &iostr_count,
+                                          raptor_parse_test_count_statement_handler);
+      iostr = raptor_new_iostream_from_filename(world, PARSE_TEST_FILENAME);
+      if(!iostr || raptor_parser_parse_iostream(parser, iostr, base_uri))
+        iostr_count = -1;
+      if(iostr)
+        raptor_free_iostream(iostr);
+
+      if(iostr_count != stream_count) {
+        fprintf(stderr,
+                "%s: parsing an iostream with read block size %d%s returned %d triples, expected %d\n",
+                program, block_sizes[i], (i == 2) ? " (adaptive)" : "",
+                iostr_count, stream_count);
+        return 1;
+      }
+    }
+    raptor_free_parser(parser);
+
+    /* guessing the syntax must not write to the file content */
+    parser = raptor_new_parser(world, "guess");
+    if(parser) {
+      int guess_count = 0;
+
+      raptor_parser_set_statement_handler(parser, &guess_count,
+                                          raptor_parse_test_count_statement_handler);
+      if(raptor_parser_parse_file(parser, file_uri, base_uri) ||
+         guess_count != file_count) {
+        fprintf(stderr,
+                "%s: guessing and parsing a file returned %d triples, expected %d\n",
+                program, guess_count, file_count);
+        return 1;
+      }
+    }
+    remove(PARSE_TEST_FILENAME);
+
+    if(file_count != PARSE_TEST_FILE_LINES + 1 || file_count != stream_count) {
+      fprintf(stderr,
+              "%s: parsing a file returned %d triples, from a stream %d; expected %d\n",
+              program, file_count, stream_count, PARSE_TEST_FILE_LINES + 1);
+      return 1;
+    }
+
+    raptor_free_uri(base_uri);
+    raptor_free_uri(file_uri);
+    if(parser)
+      raptor_free_parser(parser);
+  }
+
   raptor_free_world(world);
 
   return 0;
@@ -470,10 +470,17 @@ raptor_qname_string_to_uri(raptor_namespace_stack *nstack,
   raptor_uri *uri = NULL;
   const unsigned char *p;
   const unsigned char *original_name = name;
+  size_t original_name_len = name_len;
   const unsigned char *local_name = NULL;
   unsigned int local_name_length = 0;
   raptor_namespace* ns;
 
+  if(name) {
+    uri = raptor_namespaces_qname_cache_find(nstack, name, name_len);
+    if(uri)
+      return uri;
+  }
+
   /* Empty string is default namespace URI */
   if(!name) {
     ns = raptor_namespaces_get_default_namespace(nstack);
@@ -529,6 +536,10 @@ raptor_qname_string_to_uri(raptor_namespace_stack *nstack,
       uri = raptor_new_uri_from_uri_local_name(nstack->world, uri, local_name);
     else
       uri = raptor_uri_copy(uri);
+
+    if(uri && original_name)
+      raptor_namespaces_qname_cache_add(nstack, original_name,
+                                        original_name_len, uri);
   }
 
   return uri;
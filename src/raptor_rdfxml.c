@@ -1243,11 +1243,11 @@ raptor_rdfxml_generate_statement(raptor_parser *rdf_parser,
     rdf_parser->emitted_default_graph++;
   }
 
-  if(!rdf_parser->statement_handler)
+  if(!RAPTOR_PARSER_HAS_STATEMENT_HANDLER(rdf_parser))
     goto generate_tidy;
 
   /* Generate the statement; or is it a fact? */
-  (*rdf_parser->statement_handler)(rdf_parser->user_data, statement);
+  raptor_parser_emit_statement(rdf_parser, statement);
 
 
   /* the bagID mess */
@@ -1293,7 +1293,7 @@ raptor_rdfxml_generate_statement(raptor_parser *rdf_parser,
     }
     
     statement->object = reified_term;
-    (*rdf_parser->statement_handler)(rdf_parser->user_data, statement);
+    raptor_parser_emit_statement(rdf_parser, statement);
 
     if(bag_predicate_term)
       raptor_free_term(bag_predicate_term);
@@ -1310,23 +1310,23 @@ raptor_rdfxml_generate_statement(raptor_parser *rdf_parser,
   statement->subject = reified_term;
   statement->predicate = RAPTOR_RDF_type_term(rdf_parser->world);
   statement->object = RAPTOR_RDF_Statement_term(rdf_parser->world);
-  (*rdf_parser->statement_handler)(rdf_parser->user_data, statement);
+  raptor_parser_emit_statement(rdf_parser, statement);
 
   /* statement->subject = reified_term; */
   statement->predicate = RAPTOR_RDF_subject_term(rdf_parser->world);
   statement->object = subject_term;
-  (*rdf_parser->statement_handler)(rdf_parser->user_data, statement);
+  raptor_parser_emit_statement(rdf_parser, statement);
 
 
   /* statement->subject = reified_term; */
   statement->predicate = RAPTOR_RDF_predicate_term(rdf_parser->world);
   statement->object = predicate_term;
-  (*rdf_parser->statement_handler)(rdf_parser->user_data, statement);
+  raptor_parser_emit_statement(rdf_parser, statement);
 
   /* statement->subject = reified_term; */
   statement->predicate = RAPTOR_RDF_object_term(rdf_parser->world);
   statement->object = object_term;
-  (*rdf_parser->statement_handler)(rdf_parser->user_data, statement);
+  raptor_parser_emit_statement(rdf_parser, statement);
 
 
  generate_tidy:
@@ -1152,7 +1152,7 @@ raptor_rss_emit_type_triple(raptor_parser* rdf_parser,
   rss_parser->statement.object = object_term;
   
   /* Generate the statement */
-  (*rdf_parser->statement_handler)(rdf_parser->user_data, &rss_parser->statement);
+  raptor_parser_emit_statement(rdf_parser, &rss_parser->statement);
 
   raptor_free_term(predicate_term);
   raptor_free_term(object_term);
@@ -1186,8 +1186,7 @@ raptor_rss_emit_block(raptor_parser* rdf_parser,
   rss_parser->statement.subject = resource;
   rss_parser->statement.predicate = predicate_term;
   rss_parser->statement.object = block->identifier;
-  (*rdf_parser->statement_handler)(rdf_parser->user_data,
-                                   &rss_parser->statement);
+  raptor_parser_emit_statement(rdf_parser, &rss_parser->statement);
 
   raptor_free_term(predicate_term); predicate_term = NULL;
 
@@ -1220,8 +1219,7 @@ raptor_rss_emit_block(raptor_parser* rdf_parser,
         
         object_term = raptor_new_term_from_uri(rdf_parser->world, uri);
         rss_parser->statement.object = object_term;
-        (*rdf_parser->statement_handler)(rdf_parser->user_data,
-                                         &rss_parser->statement);
+        raptor_parser_emit_statement(rdf_parser, &rss_parser->statement);
         raptor_free_term(object_term);
       }
     } else if(attribute_type == RSS_BLOCK_FIELD_TYPE_STRING) {
@@ -1233,8 +1231,7 @@ raptor_rss_emit_block(raptor_parser* rdf_parser,
                                                    (const unsigned char*)str,
                                                    NULL, NULL);
         rss_parser->statement.object = object_term;
-        (*rdf_parser->statement_handler)(rdf_parser->user_data,
-                                         &rss_parser->statement);
+        raptor_parser_emit_statement(rdf_parser, &rss_parser->statement);
         raptor_free_term(object_term);
       }
     } else {
@@ -1306,8 +1303,7 @@ raptor_rss_emit_item(raptor_parser* rdf_parser, raptor_rss_item *item)
       rss_parser->statement.object = object_term;
       
       /* Generate the statement */
-      (*rdf_parser->statement_handler)(rdf_parser->user_data,
-                                       &rss_parser->statement);
+      raptor_parser_emit_statement(rdf_parser, &rss_parser->statement);
 
       raptor_free_term(object_term);
     }
@@ -1351,8 +1347,7 @@ raptor_rss_emit_connection(raptor_parser* rdf_parser,
   rss_parser->statement.object = object_identifier;
   
   /* Generate the statement */
-  (*rdf_parser->statement_handler)(rdf_parser->user_data,
-                                   &rss_parser->statement);
+  raptor_parser_emit_statement(rdf_parser, &rss_parser->statement);
 
   raptor_free_term(predicate_term);
   
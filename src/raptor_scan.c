@@ -0,0 +1,317 @@
+/* -*- Mode: c; c-basic-offset: 2 -*-
+ *
+ * raptor_scan.c - Search a block of memory for any byte of a small set
+ *
+ * Copyright (C) 2026, David Beckett http://www.dajobe.org/
+ *
+ * This package is Free Software and part of Redland http://librdf.org/
+ *
+ * It is licensed under the following three licenses as alternatives:
+ *   1. GNU Lesser General Public License (LGPL) V2.1 or any newer version
+ *   2. GNU General Public License (GPL) V2 or any newer version
+ *   3. Apache License, V2.0 or any newer version
+ *
+ * You may not use this file except in compliance with at least one of
+ * the above three licenses.
+ *
+ * See LICENSE.html or LICENSE.txt at the top of this package for the
+ * complete terms and further detail along with the license texts for
+ * the licenses in COPYING.LIB, COPYING and LICENSE-2.0.txt respectively.
+ *
+ *
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include <raptor_config.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+
+/* Raptor includes */
+#include "raptor2.h"
+#include "raptor_internal.h"
+
+/* SSE2 is part of the x86-64 baseline so it needs no runtime check */
+#if defined(HAVE_EMMINTRIN_H) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define RAPTOR_SCAN_SSE2 1
+#include <emmintrin.h>
+#endif
+
+/* AVX2 is compiled per-function and chosen at runtime if the CPU has it */
+#ifdef HAVE_AVX2_TARGET
+#include <immintrin.h>
+#endif
+
+
+/*
+ * raptor_scan_find_scalar:
+ * @set: scan set
+ * @p: start of memory block
+ * @end: end of memory block
+ *
+ * INTERNAL - Portable byte at a time search
+ *
+ * Return value: pointer to first byte in @set or @end if none found
+ */
+static const unsigned char*
+raptor_scan_find_scalar(const raptor_scan_set* set,
+                        const unsigned char* p, const unsigned char* end)
+{
+  while(p < end && !set->member[*p])
+    p++;
+
+  return p;
+}
+
+
+#if defined(RAPTOR_SCAN_SSE2) || defined(HAVE_AVX2_TARGET)
+/* index of lowest set bit; @mask must be non-0 */
+static int
+raptor_scan_first_bit(unsigned int mask)
+{
+#ifdef __GNUC__
+  return __builtin_ctz(mask);
+#else
+  int i = 0;
+  while(!(mask & 1)) {
+    mask >>= 1;
+    i++;
+  }
+  return i;
+#endif
+}
+#endif
+
+
+#ifdef RAPTOR_SCAN_SSE2
+/*
+ * raptor_scan_find_sse2:
+ * @set: scan set
+ * @p: start of memory block
+ * @end: end of memory block
+ *
+ * INTERNAL - SSE2 search comparing 16 bytes per step
+ *
+ * Return value: pointer to first byte in @set or @end if none found
+ */
+static const unsigned char*
+raptor_scan_find_sse2(const raptor_scan_set* set,
+                      const unsigned char* p, const unsigned char* end)
+{
+  __m128i needles[RAPTOR_SCAN_SET_MAX];
+  int count = set->count;
+  int i;
+
+  if(end - p < 16)
+    return raptor_scan_find_scalar(set, p, end);
+
+  for(i = 0; i < count; i++)
+    needles[i] = _mm_set1_epi8(RAPTOR_GOOD_CAST(char, set->bytes[i]));
+
+  while(end - p >= 16) {
+    __m128i block = _mm_loadu_si128((const __m128i*)p);
+    __m128i hits = _mm_cmpeq_epi8(block, needles[0]);
+    unsigned int mask;
+
+    for(i = 1; i < count; i++)
+      hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, needles[i]));
+
+    mask = RAPTOR_GOOD_CAST(unsigned int, _mm_movemask_epi8(hits));
+    if(mask)
+      return p + raptor_scan_first_bit(mask);
+
+    p += 16;
+  }
+
+  return raptor_scan_find_scalar(set, p, end);
+}
+#endif
+
+
+#ifdef HAVE_AVX2_TARGET
+/*
+ * raptor_scan_find_avx2:
+ * @set: scan set
+ * @p: start of memory block
+ * @end: end of memory block
+ *
+ * INTERNAL - AVX2 search comparing 32 bytes per step
+ *
+ * Only called when the CPU was found to support AVX2.
+ *
+ * Return value: pointer to first byte in @set or @end if none found
+ */
+__attribute__((target("avx2")))
+static const unsigned char*
+raptor_scan_find_avx2(const raptor_scan_set* set,
+                      const unsigned char* p, const unsigned char* end)
+{
+  __m256i needles[RAPTOR_SCAN_SET_MAX];
+  int count = set->count;
+  int i;
+
+  if(end - p < 32)
+    return raptor_scan_find_scalar(set, p, end);
+
+  for(i = 0; i < count; i++)
+    needles[i] = _mm256_set1_epi8(RAPTOR_GOOD_CAST(char, set->bytes[i]));
+
+  while(end - p >= 32) {
+    __m256i block = _mm256_loadu_si256((const __m256i*)p);
+    __m256i hits = _mm256_cmpeq_epi8(block, needles[0]);
+    unsigned int mask;
+
+    for(i = 1; i < count; i++)
+      hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(block, needles[i]));
+
+    mask = RAPTOR_GOOD_CAST(unsigned int, _mm256_movemask_epi8(hits));
+    if(mask)
+      return p + raptor_scan_first_bit(mask);
+
+    p += 32;
+  }
+
+  return raptor_scan_find_scalar(set, p, end);
+}
+#endif
+
+
+/*
+ * raptor_scan_set_init:
+ * @set: scan set to initialise
+ * @bytes: bytes to search for
+ * @count: number of bytes in @bytes (1 to #RAPTOR_SCAN_SET_MAX)
+ *
+ * INTERNAL - Initialise a scan set and pick the fastest search for this CPU
+ *
+ * Return value: non-0 on failure
+ */
+int
+raptor_scan_set_init(raptor_scan_set* set,
+                     const unsigned char* bytes, int count)
+{
+  int i;
+
+  if(count < 1 || count > RAPTOR_SCAN_SET_MAX)
+    return 1;
+
+  memset(set, '\0', sizeof(*set));
+  set->count = count;
+  for(i = 0; i < count; i++) {
+    set->bytes[i] = bytes[i];
+    set->member[bytes[i]] = 1;
+  }
+
+  set->find = raptor_scan_find_scalar;
+#ifdef RAPTOR_SCAN_SSE2
+  set->find = raptor_scan_find_sse2;
+#endif
+#ifdef HAVE_AVX2_TARGET
+  if(__builtin_cpu_supports("avx2"))
+    set->find = raptor_scan_find_avx2;
+#endif
+
+  return 0;
+}
+
+
+
+#ifdef STANDALONE
+
+/* one more prototype */
+int main(int argc, char *argv[]);
+
+
+#define SCAN_TEST_BUFFER_SIZE 200
+
+int
+main(int argc, char *argv[])
+{
+  const char *program = raptor_basename(argv[0]);
+  const unsigned char delimiters[7] = {
+    '\n', '\r', '"', '\'', '<', '>', '\\'
+  };
+  /* mostly plain bytes with a few delimiters and high bit bytes mixed in */
+  const unsigned char alphabet[] = "abcdefghijklmnop\xc3\xa9\x80\xff\n\r\"'<>\\";
+  raptor_scan_set set;
+  raptor_scan_find_handler finders[3];
+  const char* finder_names[3];
+  int finders_count = 0;
+  unsigned char buffer[SCAN_TEST_BUFFER_SIZE];
+  unsigned int seed = 1;
+  int round;
+  int failures = 0;
+
+  if(raptor_scan_set_init(&set, delimiters, 7)) {
+    fprintf(stderr, "%s: raptor_scan_set_init() failed\n", program);
+    return 1;
+  }
+
+  finders[finders_count] = raptor_scan_find_scalar;
+  finder_names[finders_count++] = "scalar";
+#ifdef RAPTOR_SCAN_SSE2
+  finders[finders_count] = raptor_scan_find_sse2;
+  finder_names[finders_count++] = "sse2";
+#endif
+#ifdef HAVE_AVX2_TARGET
+  if(__builtin_cpu_supports("avx2")) {
+    finders[finders_count] = raptor_scan_find_avx2;
+    finder_names[finders_count++] = "avx2";
+  }
+#endif
+
+  for(round = 0; round < 200; round++) {
+    int plain_run = round % 70;
+    size_t start;
+    int i;
+
+    /* runs of plain bytes of varying lengths between the delimiters */
+    for(i = 0; i < SCAN_TEST_BUFFER_SIZE; i++) {
+      seed = seed * 1103515245U + 12345U;
+      if(plain_run && ((seed >> 16) % plain_run))
+        buffer[i] = 'x';
+      else
+        buffer[i] = alphabet[(seed >> 16) % (sizeof(alphabet) - 1)];
+    }
+
+    /* every start offset covers all alignments and short tails */
+    for(start = 0; start < SCAN_TEST_BUFFER_SIZE; start++) {
+      const unsigned char* end = buffer + SCAN_TEST_BUFFER_SIZE;
+      const unsigned char* expected;
+      int f;
+
+      expected = raptor_scan_find_scalar(&set, buffer + start, end);
+      for(f = 1; f < finders_count; f++) {
+        const unsigned char* got = finders[f](&set, buffer + start, end);
+        if(got != expected) {
+          fprintf(stderr,
+                  "%s: %s search from offset %d returned offset %d expected %d\n",
+                  program, finder_names[f], (int)start,
+                  (int)(got - buffer), (int)(expected - buffer));
+          failures++;
+        }
+      }
+
+      if(raptor_scan_set_find(&set, buffer + start, end) != expected) {
+        fprintf(stderr, "%s: selected search from offset %d failed\n",
+                program, (int)start);
+        failures++;
+      }
+    }
+  }
+
+  /* empty input */
+  if(raptor_scan_set_find(&set, buffer, buffer) != buffer) {
+    fprintf(stderr, "%s: search of empty block failed\n", program);
+    failures++;
+  }
+
+  return failures;
+}
+
+#endif
@@ -42,6 +42,66 @@
 
 #ifndef STANDALONE
 
+/*
+ * raptor_term_alloc:
+ * @arena: arena or NULL to allocate on the heap
+ * @size: number of bytes
+ *
+ * INTERNAL - Allocate memory for a term or one of its strings
+ *
+ * Return value: pointer to memory or NULL on failure
+ */
+static void*
+raptor_term_alloc(raptor_arena* arena, size_t size)
+{
+  if(arena)
+    return raptor_arena_alloc(arena, size);
+
+  return RAPTOR_MALLOC(void*, size);
+}
+
+
+/*
+ * raptor_term_alloc_term:
+ * @arena: arena or NULL to allocate on the heap
+ *
+ * INTERNAL - Allocate an empty term
+ *
+ * Heap terms are usage counted.  Arena terms have usage -1 in the
+ * same way as static statements: raptor_free_term() ignores them and
+ * raptor_term_copy() copies them to the heap.
+ *
+ * Return value: new term or NULL on failure
+ */
+static raptor_term*
+raptor_term_alloc_term(raptor_arena* arena)
+{
+  raptor_term* t;
+
+  if(!arena) {
+    t = RAPTOR_CALLOC(raptor_term*, 1, sizeof(*t));
+    if(t)
+      t->usage = 1;
+    return t;
+  }
+
+  t = (raptor_term*)raptor_arena_alloc(arena, sizeof(*t));
+  if(t) {
+    memset(t, '\0', sizeof(*t));
+    t->usage = -1;
+  }
+  return t;
+}
+
+
+/* free memory from raptor_term_alloc() on an error path */
+#define RAPTOR_TERM_FREE_STRING(arena, string) \
+  do {                                          \
+    if(!(arena) && (string))                    \
+      RAPTOR_FREE(char*, string);               \
+  } while(0)
+
+
 /**
  * raptor_new_term_from_uri:
  * @world: raptor world
@@ -55,6 +115,27 @@
 */
 raptor_term*
 raptor_new_term_from_uri(raptor_world* world, raptor_uri* uri)
+{
+  return raptor_new_term_from_uri_in_arena(NULL, world, uri);
+}
+
+
+/*
+ * raptor_new_term_from_uri_in_arena:
+ * @arena: arena or NULL to allocate on the heap
+ * @world: raptor world
+ * @uri: uri
+ *
+ * INTERNAL - Constructor - create a new URI statement term in an arena
+ *
+ * The reference to @uri taken by an arena term is released when
+ * @arena is reset.
+ *
+ * Return value: new term or NULL on failure
+ */
+raptor_term*
+raptor_new_term_from_uri_in_arena(raptor_arena* arena, raptor_world* world,
+                                  raptor_uri* uri)
 {
   raptor_term *t;
 
@@ -65,15 +146,17 @@ raptor_new_term_from_uri(raptor_world* world, raptor_uri* uri)
   
   raptor_world_open(world);
 
-  t = RAPTOR_CALLOC(raptor_term*, 1, sizeof(*t));
+  t = raptor_term_alloc_term(arena);
   if(!t)
     return NULL;
 
-  t->usage = 1;
   t->world = world;
   t->type = RAPTOR_TERM_TYPE_URI;
   t->value.uri = raptor_uri_copy(uri);
 
+  if(arena && raptor_arena_add_uri(arena, t->value.uri))
+    return NULL;
+
   return t;
 }
 
@@ -95,6 +178,28 @@ raptor_term*
 raptor_new_term_from_counted_uri_string(raptor_world* world, 
                                         const unsigned char *uri_string,
                                         size_t length)
+{
+  return raptor_new_term_from_counted_uri_string_in_arena(NULL, world,
+                                                          uri_string, length);
+}
+
+
+/*
+ * raptor_new_term_from_counted_uri_string_in_arena:
+ * @arena: arena or NULL to allocate on the heap
+ * @world: raptor world
+ * @uri_string: UTF-8 encoded URI string.
+ * @length: length of URI string
+ *
+ * INTERNAL - Constructor - create a new URI statement term in an arena
+ *
+ * Return value: new term or NULL on failure
+ */
+raptor_term*
+raptor_new_term_from_counted_uri_string_in_arena(raptor_arena* arena,
+                                                 raptor_world* world,
+                                                 const unsigned char *uri_string,
+                                                 size_t length)
 {
   raptor_term *t;
   raptor_uri* uri;
@@ -105,7 +210,7 @@ raptor_new_term_from_counted_uri_string(raptor_world* world,
   if(!uri)
     return NULL;
 
-  t = raptor_new_term_from_uri(world, uri);
+  t = raptor_new_term_from_uri_in_arena(arena, world, uri);
   
   raptor_free_uri(uri);
   
@@ -176,6 +281,58 @@ raptor_new_term_from_counted_literal(raptor_world* world,
                                      raptor_uri* datatype,
                                      const unsigned char* language,
                                      unsigned char language_len)
+{
+  return raptor_new_term_from_counted_literal_in_arena(NULL, world,
+                                                       literal, literal_len,
+                                                       datatype,
+                                                       language, language_len);
+}
+
+
+/* literals with datatype xsd:string are stored as plain literals */
+static int
+raptor_term_datatype_is_xsd_string(raptor_uri* datatype)
+{
+  const unsigned char* datatype_string;
+  size_t datatype_len;
+  size_t xsd_namespace_len;
+
+  datatype_string = raptor_uri_as_counted_string(datatype, &datatype_len);
+  xsd_namespace_len = strlen(
+      (const char*)raptor_xmlschema_datatypes_namespace_uri);
+
+  return (datatype_len == xsd_namespace_len + 6 &&
+          !memcmp(datatype_string, raptor_xmlschema_datatypes_namespace_uri,
+                  xsd_namespace_len) &&
+          !memcmp(datatype_string + xsd_namespace_len, "string", 6));
+}
+
+
+/*
+ * raptor_new_term_from_counted_literal_in_arena:
+ * @arena: arena or NULL to allocate on the heap
+ * @world: raptor world
+ * @literal: UTF-8 encoded literal string (or NULL for empty literal)
+ * @literal_len: length of literal
+ * @datatype: literal datatype URI (or NULL)
+ * @language: literal language (or NULL for no language)
+ * @language_len: literal language length
+ *
+ * INTERNAL - Constructor - create a new literal statement term in an arena
+ *
+ * As raptor_new_term_from_counted_literal() with the term, literal
+ * and language allocated from @arena when it is not NULL.
+ *
+ * Return value: new term or NULL on failure
+ */
+raptor_term*
+raptor_new_term_from_counted_literal_in_arena(raptor_arena* arena,
+                                              raptor_world* world,
+                                              const unsigned char* literal,
+                                              size_t literal_len,
+                                              raptor_uri* datatype,
+                                              const unsigned char* language,
+                                              unsigned char language_len)
 {
   raptor_term *t;
   unsigned char* new_literal = NULL;
@@ -191,20 +348,8 @@ raptor_new_term_from_counted_literal(raptor_world* world,
   if(language && datatype)
     return NULL;
 
-  if(datatype) {
-    const unsigned char* datatype_string;
-    size_t datatype_len;
-    size_t xsd_namespace_len;
-
-    datatype_string = raptor_uri_as_counted_string(datatype, &datatype_len);
-    xsd_namespace_len = strlen(
-        (const char*)raptor_xmlschema_datatypes_namespace_uri);
-    if(datatype_len == xsd_namespace_len + 6 &&
-       !memcmp(datatype_string, raptor_xmlschema_datatypes_namespace_uri,
-               xsd_namespace_len) &&
-       !memcmp(datatype_string + xsd_namespace_len, "string", 6))
-      datatype = NULL;
-  }
+  if(datatype && raptor_term_datatype_is_xsd_string(datatype))
+    datatype = NULL;
 
   if(!literal || !*literal)
     literal_len = 0;
@@ -212,7 +357,7 @@ raptor_new_term_from_counted_literal(raptor_world* world,
   if(RAPTOR_SIZE_T_ADD_OVERFLOWS(literal_len, 1))
     return NULL;
 
-  new_literal = RAPTOR_MALLOC(unsigned char*, literal_len + 1);
+  new_literal = (unsigned char*)raptor_term_alloc(arena, literal_len + 1);
   if(!new_literal)
     return NULL;
 
@@ -228,13 +373,14 @@ raptor_new_term_from_counted_literal(raptor_world* world,
     size_t i;
 
     if(RAPTOR_SIZE_T_ADD_OVERFLOWS((size_t)language_len, 1)) {
-      RAPTOR_FREE(char*, new_literal);
+      RAPTOR_TERM_FREE_STRING(arena, new_literal);
       return NULL;
     }
 
-    new_language = RAPTOR_MALLOC(unsigned char*, language_len + 1);
+    new_language = (unsigned char*)raptor_term_alloc(arena,
+                                                     language_len + 1);
     if(!new_language) {
-      RAPTOR_FREE(char*, new_literal);
+      RAPTOR_TERM_FREE_STRING(arena, new_literal);
       return NULL;
     }
 
@@ -251,21 +397,20 @@ raptor_new_term_from_counted_literal(raptor_world* world,
   } else
     language_len = 0;
 
-  if(datatype)
+  if(datatype) {
     datatype = raptor_uri_copy(datatype);
-  
+    if(arena && raptor_arena_add_uri(arena, datatype))
+      return NULL;
+  }
 
-  t = RAPTOR_CALLOC(raptor_term*, 1, sizeof(*t));
+  t = raptor_term_alloc_term(arena);
   if(!t) {
-    if(new_literal)
-      RAPTOR_FREE(char*, new_literal);
-    if(new_language)
-      RAPTOR_FREE(char*, new_language);
-    if(datatype)
+    RAPTOR_TERM_FREE_STRING(arena, new_literal);
+    RAPTOR_TERM_FREE_STRING(arena, new_language);
+    if(datatype && !arena)
       raptor_free_uri(datatype);
     return NULL;
   }
-  t->usage = 1;
   t->world = world;
   t->type = RAPTOR_TERM_TYPE_LITERAL;
   t->value.literal.string = new_literal;
@@ -278,6 +423,104 @@ raptor_new_term_from_counted_literal(raptor_world* world,
 }
 
 
+/*
+ * raptor_new_term_from_counted_literal_owned:
+ * @world: raptor world
+ * @literal: UTF-8 encoded literal string (or NULL for empty literal)
+ * @literal_len: length of literal
+ * @datatype: literal datatype URI (or NULL)
+ * @language: literal language (or NULL for no language)
+ *
+ * INTERNAL - Constructor - create a new literal statement term from parts it takes ownership of
+ *
+ * As raptor_new_term_from_counted_literal() but @literal and
+ * @language must have been allocated with RAPTOR_MALLOC() and become
+ * the strings of the new term, and the reference to @datatype becomes
+ * the term's.  All of them are freed if the term cannot be made.
+ *
+ * This saves a parser that has already decoded a token into its own
+ * string from copying it again.  @literal must be NUL terminated at
+ * @literal_len and @language NUL terminated.
+ *
+ * Return value: new term or NULL on failure
+ */
+raptor_term*
+raptor_new_term_from_counted_literal_owned(raptor_world* world,
+                                           unsigned char* literal,
+                                           size_t literal_len,
+                                           raptor_uri* datatype,
+                                           unsigned char* language)
+{
+  raptor_term *t;
+  size_t language_len = 0;
+
+  if(raptor_check_world_internal(world, __FUNCTION__))
+    goto failed;
+
+  raptor_world_open(world);
+
+  if(language && !*language) {
+    RAPTOR_FREE(char*, language);
+    language = NULL;
+  }
+
+  if(language && datatype)
+    goto failed;
+
+  if(datatype && raptor_term_datatype_is_xsd_string(datatype)) {
+    raptor_free_uri(datatype);
+    datatype = NULL;
+  }
+
+  if(!literal) {
+    literal = RAPTOR_MALLOC(unsigned char*, 1);
+    if(!literal)
+      goto failed;
+    *literal = '\0';
+    literal_len = 0;
+  }
+
+  if(language) {
+    unsigned char* l;
+
+    /* normalise in place as raptor_new_term_from_counted_literal() */
+    for(l = language; *l; l++) {
+      if(*l >= 'A' && *l <= 'Z')
+        *l = RAPTOR_GOOD_CAST(unsigned char, *l + ('a' - 'A'));
+      if(*l == '_')
+        *l = '-';
+    }
+    language_len = RAPTOR_GOOD_CAST(size_t, l - language);
+    if(language_len > 255)
+      goto failed;
+  }
+
+  t = raptor_term_alloc_term(NULL);
+  if(!t)
+    goto failed;
+
+  t->world = world;
+  t->type = RAPTOR_TERM_TYPE_LITERAL;
+  t->value.literal.string = literal;
+  t->value.literal.string_len = RAPTOR_LANG_LEN_FROM_INT(literal_len);
+  t->value.literal.language = language;
+  t->value.literal.language_len = RAPTOR_BAD_CAST(unsigned char, language_len);
+  t->value.literal.datatype = datatype;
+
+  return t;
+
+  failed:
+  if(literal)
+    RAPTOR_FREE(char*, literal);
+  if(language)
+    RAPTOR_FREE(char*, language);
+  if(datatype)
+    raptor_free_uri(datatype);
+
+  return NULL;
+}
+
+
 /**
  * raptor_new_term_from_literal:
  * @world: raptor world
@@ -345,6 +588,28 @@ raptor_new_term_from_literal(raptor_world* world,
 raptor_term*
 raptor_new_term_from_counted_blank(raptor_world* world,
                                    const unsigned char* blank, size_t length)
+{
+  return raptor_new_term_from_counted_blank_in_arena(NULL, world,
+                                                     blank, length);
+}
+
+
+/*
+ * raptor_new_term_from_counted_blank_in_arena:
+ * @arena: arena or NULL to allocate on the heap
+ * @world: raptor world
+ * @blank: UTF-8 encoded blank node identifier (or NULL)
+ * @length: length of identifier (or 0)
+ *
+ * INTERNAL - Constructor - create a new blank node statement term in an arena
+ *
+ * Return value: new term or NULL on failure
+ */
+raptor_term*
+raptor_new_term_from_counted_blank_in_arena(raptor_arena* arena,
+                                            raptor_world* world,
+                                            const unsigned char* blank,
+                                            size_t length)
 {
   raptor_term *t;
   unsigned char* new_id;
@@ -357,23 +622,36 @@ raptor_new_term_from_counted_blank(raptor_world* world,
     if(RAPTOR_SIZE_T_ADD_OVERFLOWS(length, 1))
       return NULL;
 
-    new_id = RAPTOR_MALLOC(unsigned char*, length + 1);
+    new_id = (unsigned char*)raptor_term_alloc(arena, length + 1);
     if(!new_id)
       return NULL;
     memcpy(new_id, blank, length);
     new_id[length] = '\0';
   } else {
     new_id = raptor_world_generate_bnodeid(world);
+    if(!new_id)
+      return NULL;
     length = strlen((const char*)new_id);
+
+    if(arena) {
+      unsigned char* arena_id;
+
+      arena_id = (unsigned char*)raptor_arena_alloc(arena, length + 1);
+      if(arena_id)
+        memcpy(arena_id, new_id, length + 1);
+      RAPTOR_FREE(char*, new_id);
+      new_id = arena_id;
+      if(!new_id)
+        return NULL;
+    }
   }
 
-  t = RAPTOR_CALLOC(raptor_term*, 1, sizeof(*t));
+  t = raptor_term_alloc_term(arena);
   if(!t) {
-    RAPTOR_FREE(char*, new_id);
+    RAPTOR_TERM_FREE_STRING(arena, new_id);
     return NULL;
   }
 
-  t->usage = 1;
   t->world = world;
   t->type = RAPTOR_TERM_TYPE_BLANK;
   t->value.blank.string = new_id;
@@ -383,6 +661,49 @@ raptor_new_term_from_counted_blank(raptor_world* world,
 }
 
 
+/*
+ * raptor_new_term_from_counted_blank_owned:
+ * @world: raptor world
+ * @blank: UTF-8 encoded blank node identifier
+ * @length: length of identifier
+ *
+ * INTERNAL - Constructor - create a new blank node statement term from an identifier it takes ownership of
+ *
+ * As raptor_new_term_from_counted_blank() but @blank must have been
+ * allocated with RAPTOR_MALLOC(), such as by
+ * raptor_world_internal_generate_id(), and becomes the identifier of
+ * the new term.  It is freed if the term cannot be made.
+ *
+ * Return value: new term or NULL on failure
+ */
+raptor_term*
+raptor_new_term_from_counted_blank_owned(raptor_world* world,
+                                         unsigned char* blank, size_t length)
+{
+  raptor_term *t;
+
+  if(raptor_check_world_internal(world, __FUNCTION__)) {
+    RAPTOR_FREE(char*, blank);
+    return NULL;
+  }
+
+  raptor_world_open(world);
+
+  t = raptor_term_alloc_term(NULL);
+  if(!t) {
+    RAPTOR_FREE(char*, blank);
+    return NULL;
+  }
+
+  t->world = world;
+  t->type = RAPTOR_TERM_TYPE_BLANK;
+  t->value.blank.string = blank;
+  t->value.blank.string_len = RAPTOR_BAD_CAST(int, length);
+
+  return t;
+}
+
+
 /**
  * raptor_new_term_from_blank:
  * @world: raptor world
@@ -451,7 +772,7 @@ raptor_new_term_from_counted_string(raptor_world* world,
   memset(&locator, '\0', sizeof(locator));
   locator.line = -1;
 
-  bytes_read = raptor_ntriples_parse_term(world, &locator,
+  bytes_read = raptor_ntriples_parse_term(world, NULL, &locator,
                                           string, &length, &term, 1);
 
   if(!bytes_read || length != 0) {
@@ -464,6 +785,43 @@ raptor_new_term_from_counted_string(raptor_world* world,
 }
 
 
+/*
+ * raptor_term_copy_from_arena:
+ * @term: arena term
+ *
+ * INTERNAL - Copy a term allocated in an arena to a new heap term
+ *
+ * Return value: new term or NULL on failure
+ */
+static raptor_term*
+raptor_term_copy_from_arena(raptor_term* term)
+{
+  switch(term->type) {
+    case RAPTOR_TERM_TYPE_URI:
+      return raptor_new_term_from_uri(term->world, term->value.uri);
+
+    case RAPTOR_TERM_TYPE_BLANK:
+      return raptor_new_term_from_counted_blank(term->world,
+                                                term->value.blank.string,
+                                                RAPTOR_GOOD_CAST(size_t, term->value.blank.string_len));
+
+    case RAPTOR_TERM_TYPE_LITERAL:
+      return raptor_new_term_from_counted_literal(term->world,
+                                                  term->value.literal.string,
+                                                  RAPTOR_GOOD_CAST(size_t, term->value.literal.string_len),
+                                                  term->value.literal.datatype,
+                                                  term->value.literal.language,
+                                                  term->value.literal.language_len);
+
+    case RAPTOR_TERM_TYPE_UNKNOWN:
+    default:
+      break;
+  }
+
+  return NULL;
+}
+
+
 /**
  * raptor_term_copy:
  * @term: raptor term
@@ -478,7 +836,11 @@ raptor_term_copy(raptor_term* term)
   if(!term)
     return NULL;
 
-  term->usage++;
+  /* arena - not usage counted */
+  if(term->usage < 0)
+    return raptor_term_copy_from_arena(term);
+
+  RAPTOR_ATOMIC_INCREMENT(&term->usage);
   return term;
 }
 
@@ -496,7 +858,11 @@ raptor_free_term(raptor_term *term)
   if(!term)
     return;
   
-  if(--term->usage)
+  /* arena - freed when the arena is reset */
+  if(term->usage < 0)
+    return;
+
+  if(RAPTOR_ATOMIC_DECREMENT(&term->usage))
     return;
   
   switch(term->type) {
@@ -1289,6 +1655,184 @@ main(int argc, char *argv[])
   }
   
 
+  /* check terms allocated in an arena equal the heap terms and that
+   * copies of them outlive an arena reset.  The small block size
+   * makes the arena use several blocks and oversized allocations. */
+  if(1) {
+#define ARENA_TEST_ROUNDS 3
+#define ARENA_TEST_TERMS 4
+    raptor_arena* arena;
+    raptor_uri* datatype_uri;
+    raptor_term* heap_terms[ARENA_TEST_TERMS];
+    raptor_term* copied_terms[ARENA_TEST_TERMS];
+    unsigned char long_literal[200];
+    int round;
+    int t;
+
+    memset(long_literal, 'x', sizeof(long_literal) - 1);
+    long_literal[sizeof(long_literal) - 1] = '\0';
+
+    datatype_uri = raptor_new_uri(world, (const unsigned char*)"http://www.w3.org/2001/XMLSchema#integer");
+    heap_terms[0] = raptor_new_term_from_counted_uri_string(world, uri_string1,
+                                                            uri_string1_len);
+    heap_terms[1] = raptor_new_term_from_counted_literal(world,
+                                  literal_string1, literal_string1_len, NULL,
+                                  (const unsigned char*)"EN_gb", 5);
+    heap_terms[2] = raptor_new_term_from_literal(world, long_literal,
+                                                 datatype_uri, NULL);
+    heap_terms[3] = raptor_new_term_from_counted_blank(world, bnodeid1,
+                                                       bnodeid1_len);
+
+    arena = raptor_new_arena(64);
+    if(!arena) {
+      fprintf(stderr, "%s: raptor_new_arena() failed\n", program);
+      rc = 1;
+    }
+
+    for(round = 0; !rc && round < ARENA_TEST_ROUNDS; round++) {
+      raptor_term* arena_terms[ARENA_TEST_TERMS];
+      raptor_term* generated_term;
+
+      arena_terms[0] = raptor_new_term_from_counted_uri_string_in_arena(arena,
+                                   world, uri_string1, uri_string1_len);
+      arena_terms[1] = raptor_new_term_from_counted_literal_in_arena(arena,
+                                   world, literal_string1, literal_string1_len,
+                                   NULL, (const unsigned char*)"EN_gb", 5);
+      arena_terms[2] = raptor_new_term_from_counted_literal_in_arena(arena,
+                                   world, long_literal,
+                                   sizeof(long_literal) - 1, datatype_uri,
+                                   NULL, 0);
+      arena_terms[3] = raptor_new_term_from_counted_blank_in_arena(arena,
+                                   world, bnodeid1, bnodeid1_len);
+      generated_term = raptor_new_term_from_counted_blank_in_arena(arena,
+                                   world, NULL, 0);
+      if(!generated_term || !generated_term->value.blank.string_len) {
+        fprintf(stderr, "%s: arena term with a generated blank node ID failed\n",
+                program);
+        rc = 1;
+      }
+
+      for(t = 0; t < ARENA_TEST_TERMS; t++) {
+        copied_terms[t] = NULL;
+        if(!arena_terms[t] || arena_terms[t]->usage != -1 ||
+           !raptor_term_equals(arena_terms[t], heap_terms[t])) {
+          fprintf(stderr, "%s: round %d arena term %d differs from heap term\n",
+                  program, round, t);
+          rc = 1;
+          continue;
+        }
+        /* does nothing for an arena term */
+        raptor_free_term(arena_terms[t]);
+
+        copied_terms[t] = raptor_term_copy(arena_terms[t]);
+        if(!copied_terms[t] || copied_terms[t] == arena_terms[t] ||
+           copied_terms[t]->usage != 1) {
+          fprintf(stderr, "%s: round %d copy of arena term %d is not a heap term\n",
+                  program, round, t);
+          rc = 1;
+        }
+      }
+
+      raptor_arena_reset(arena);
+
+      for(t = 0; t < ARENA_TEST_TERMS; t++) {
+        if(copied_terms[t]) {
+          if(!raptor_term_equals(copied_terms[t], heap_terms[t])) {
+            fprintf(stderr, "%s: round %d copy of arena term %d changed after reset\n",
+                    program, round, t);
+            rc = 1;
+          }
+          raptor_free_term(copied_terms[t]);
+        }
+      }
+    }
+
+    if(arena)
+      raptor_free_arena(arena);
+    for(t = 0; t < ARENA_TEST_TERMS; t++)
+      raptor_free_term(heap_terms[t]);
+    raptor_free_uri(datatype_uri);
+    if(rc)
+      goto tidy;
+  }
+
+
+  /* check terms that take ownership of their strings equal the
+   * copying constructors' terms */
+  if(1) {
+    raptor_term* owned_term;
+    raptor_term* copied_term;
+    unsigned char* string;
+    unsigned char* language;
+
+    string = RAPTOR_MALLOC(unsigned char*, 2);
+    language = RAPTOR_MALLOC(unsigned char*, 6);
+    if(string && language) {
+      memcpy(string, "x", 2);
+      memcpy(language, "EN_gb", 6);
+    }
+    owned_term = raptor_new_term_from_counted_literal_owned(world, string, 1,
+                                                            NULL, language);
+    if(!owned_term || owned_term->value.literal.string != string ||
+       !raptor_term_equals(owned_term, en_gb_term)) {
+      fprintf(stderr, "%s: owned literal term differs from %s\n", program,
+              "en_gb_term");
+      rc = 1;
+    }
+    if(owned_term)
+      raptor_free_term(owned_term);
+
+    /* an xsd:string datatype is dropped and its reference released */
+    string = RAPTOR_MALLOC(unsigned char*, 2);
+    if(string)
+      memcpy(string, "x", 2);
+    owned_term = raptor_new_term_from_counted_literal_owned(world, string, 1,
+                                  raptor_uri_copy(xsd_string_uri), NULL);
+    if(!owned_term || !raptor_term_equals(owned_term, plain_string_term)) {
+      fprintf(stderr, "%s: owned xsd:string literal term differs from %s\n",
+              program, "plain_string_term");
+      rc = 1;
+    }
+    if(owned_term)
+      raptor_free_term(owned_term);
+
+    /* language and datatype together fail and free both */
+    string = RAPTOR_MALLOC(unsigned char*, 2);
+    language = RAPTOR_MALLOC(unsigned char*, 3);
+    if(string && language) {
+      memcpy(string, "x", 2);
+      memcpy(language, "en", 3);
+    }
+    owned_term = raptor_new_term_from_counted_literal_owned(world, string, 1,
+                                  raptor_uri_copy(xsd_string_uri), language);
+    if(owned_term) {
+      fprintf(stderr, "%s: owned literal with language and datatype succeeded\n",
+              program);
+      raptor_free_term(owned_term);
+      rc = 1;
+    }
+
+    string = RAPTOR_MALLOC(unsigned char*, bnodeid1_len + 1);
+    if(string)
+      memcpy(string, bnodeid1, bnodeid1_len + 1);
+    owned_term = raptor_new_term_from_counted_blank_owned(world, string,
+                                                          bnodeid1_len);
+    copied_term = raptor_new_term_from_counted_blank(world, bnodeid1,
+                                                     bnodeid1_len);
+    if(!owned_term || !raptor_term_equals(owned_term, copied_term)) {
+      fprintf(stderr, "%s: owned blank term differs from copied blank term\n",
+              program);
+      rc = 1;
+    }
+    if(owned_term)
+      raptor_free_term(owned_term);
+    if(copied_term)
+      raptor_free_term(copied_term);
+    if(rc)
+      goto tidy;
+  }
+
+
   tidy:
   if(term1)
     raptor_free_term(term1);
@@ -684,6 +684,11 @@ raptor_turtle_writer_set_option(raptor_turtle_writer *turtle_writer,
     case RAPTOR_OPTION_HTML_LINK:
     case RAPTOR_OPTION_WWW_TIMEOUT:
     case RAPTOR_OPTION_STRICT:
+    case RAPTOR_OPTION_PARSE_THREADS:
+    case RAPTOR_OPTION_PARSE_UNORDERED:
+    case RAPTOR_OPTION_READ_BLOCK_SIZE:
+    case RAPTOR_OPTION_READ_BLOCK_ADAPTIVE:
+    case RAPTOR_OPTION_PARSE_ARENA:
       
     /* Shared */
     case RAPTOR_OPTION_NO_NET:
@@ -808,6 +813,11 @@ raptor_turtle_writer_get_option(raptor_turtle_writer *turtle_writer,
     case RAPTOR_OPTION_HTML_LINK:
     case RAPTOR_OPTION_WWW_TIMEOUT:
     case RAPTOR_OPTION_STRICT:
+    case RAPTOR_OPTION_PARSE_THREADS:
+    case RAPTOR_OPTION_PARSE_UNORDERED:
+    case RAPTOR_OPTION_READ_BLOCK_SIZE:
+    case RAPTOR_OPTION_READ_BLOCK_ADAPTIVE:
+    case RAPTOR_OPTION_PARSE_ARENA:
 
     /* Shared */
     case RAPTOR_OPTION_NO_NET:
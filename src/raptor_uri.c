@@ -82,8 +82,36 @@ struct raptor_uri_s {
   unsigned int length;
   /* usage count */
   int usage;
+  /* hash of string */
+  unsigned int hash;
 };
 
+
+/* one shard of the interned URI table using open addressing and
+ * linear probing */
+typedef struct {
+  /* URI in each slot or NULL if empty */
+  raptor_uri** slots;
+  /* number of slots; always a power of 2 */
+  size_t size;
+  /* number of URIs in the shard */
+  size_t count;
+  /* held while the shard or a usage count dropping to 0 changes */
+  raptor_mutex lock;
+} raptor_uri_shard;
+
+/* Number of shards in the interned URI table; a power of 2 */
+#define RAPTOR_URI_TABLE_SHARDS 16
+
+/* table of interned URIs; split into shards selected by the top bits
+ * of the URI hash so that threads sharing a world rarely contend */
+struct raptor_uri_table_s {
+  raptor_uri_shard shards[RAPTOR_URI_TABLE_SHARDS];
+};
+
+#define RAPTOR_URI_TABLE_SHARD(table, hash) \
+  (&(table)->shards[(hash) >> 28 & (RAPTOR_URI_TABLE_SHARDS - 1)])
+
 #ifndef STANDALONE
 
 #define RAPTOR_URI_GETCWD_MAX 65536
@@ -219,6 +247,240 @@ raptor_uri_copy_file_path_decoded(const unsigned char *path, char *to)
   return (size_t)(p - to);
 }
 
+/* Initial number of slots in each URI table shard */
+#define RAPTOR_URI_SHARD_INITIAL_SIZE 64
+
+/*
+ * raptor_uri_hash_string:
+ * @string: URI string
+ * @length: length of @string
+ *
+ * INTERNAL - Hash a URI string with FNV-1a
+ *
+ * Return value: hash
+ */
+static unsigned int
+raptor_uri_hash_string(const unsigned char *string, size_t length)
+{
+  unsigned int hash = 2166136261U;
+
+  while(length--) {
+    hash ^= *string++;
+    hash *= 16777619U;
+  }
+
+  return hash;
+}
+
+
+/*
+ * raptor_new_uri_table:
+ *
+ * INTERNAL - Constructor - create an empty URI table
+ *
+ * Return value: new table or NULL on failure
+ */
+static raptor_uri_table*
+raptor_new_uri_table(void)
+{
+  raptor_uri_table* table;
+  int i;
+
+  table = RAPTOR_CALLOC(raptor_uri_table*, 1, sizeof(*table));
+  if(!table)
+    return NULL;
+
+  for(i = 0; i < RAPTOR_URI_TABLE_SHARDS; i++) {
+    raptor_uri_shard* shard = &table->shards[i];
+
+    shard->slots = RAPTOR_CALLOC(raptor_uri**, RAPTOR_URI_SHARD_INITIAL_SIZE,
+                                 sizeof(raptor_uri*));
+    if(!shard->slots)
+      break;
+    shard->size = RAPTOR_URI_SHARD_INITIAL_SIZE;
+    RAPTOR_MUTEX_INIT(&shard->lock);
+  }
+
+  if(i < RAPTOR_URI_TABLE_SHARDS) {
+    while(--i >= 0) {
+      RAPTOR_MUTEX_DESTROY(&table->shards[i].lock);
+      RAPTOR_FREE(raptor_uri**, table->shards[i].slots);
+    }
+    RAPTOR_FREE(raptor_uri_table, table);
+    return NULL;
+  }
+
+  return table;
+}
+
+
+/*
+ * raptor_free_uri_table:
+ * @table: URI table
+ *
+ * INTERNAL - Destructor - destroy a URI table but not the URIs in it
+ */
+static void
+raptor_free_uri_table(raptor_uri_table* table)
+{
+  int i;
+
+  for(i = 0; i < RAPTOR_URI_TABLE_SHARDS; i++) {
+    RAPTOR_MUTEX_DESTROY(&table->shards[i].lock);
+    RAPTOR_FREE(raptor_uri**, table->shards[i].slots);
+  }
+  RAPTOR_FREE(raptor_uri_table, table);
+}
+
+
+/*
+ * raptor_uri_shard_find:
+ * @shard: URI table shard (locked)
+ * @string: URI string
+ * @length: length of @string
+ * @hash: hash of @string
+ *
+ * INTERNAL - Find an interned URI by string
+ *
+ * Return value: URI or NULL if not present
+ */
+static raptor_uri*
+raptor_uri_shard_find(raptor_uri_shard* shard, const unsigned char *string,
+                      unsigned int length, unsigned int hash)
+{
+  size_t mask = shard->size - 1;
+  size_t i;
+  raptor_uri* uri;
+
+  for(i = hash & mask; (uri = shard->slots[i]); i = (i + 1) & mask) {
+    if(uri->hash == hash && uri->length == length &&
+       !memcmp(uri->string, string, length))
+      return uri;
+  }
+
+  return NULL;
+}
+
+
+/*
+ * raptor_uri_shard_grow:
+ * @shard: URI table shard (locked)
+ *
+ * INTERNAL - Double the number of slots in a URI table shard
+ *
+ * Return value: non-0 on failure
+ */
+static int
+raptor_uri_shard_grow(raptor_uri_shard* shard)
+{
+  raptor_uri** slots;
+  size_t size;
+  size_t mask;
+  size_t j;
+
+  if(RAPTOR_SIZE_T_MUL_OVERFLOWS(shard->size, 2 * sizeof(raptor_uri*)))
+    return 1;
+  size = shard->size * 2;
+
+  slots = RAPTOR_CALLOC(raptor_uri**, size, sizeof(raptor_uri*));
+  if(!slots)
+    return 1;
+
+  mask = size - 1;
+  for(j = 0; j < shard->size; j++) {
+    raptor_uri* uri = shard->slots[j];
+    size_t i;
+
+    if(!uri)
+      continue;
+
+    for(i = uri->hash & mask; slots[i]; i = (i + 1) & mask)
+      ;
+    slots[i] = uri;
+  }
+
+  RAPTOR_FREE(raptor_uri**, shard->slots);
+  shard->slots = slots;
+  shard->size = size;
+
+  return 0;
+}
+
+
+/*
+ * raptor_uri_shard_add:
+ * @shard: URI table shard (locked)
+ * @uri: URI not already in the shard
+ *
+ * INTERNAL - Add a URI to a URI table shard
+ *
+ * Return value: non-0 on failure
+ */
+static int
+raptor_uri_shard_add(raptor_uri_shard* shard, raptor_uri* uri)
+{
+  size_t mask;
+  size_t i;
+
+  /* keep the shard at most half full so probe sequences stay short */
+  if((shard->count + 1) * 2 > shard->size && raptor_uri_shard_grow(shard))
+    return 1;
+
+  mask = shard->size - 1;
+  for(i = uri->hash & mask; shard->slots[i]; i = (i + 1) & mask)
+    ;
+  shard->slots[i] = uri;
+  shard->count++;
+
+  return 0;
+}
+
+
+/*
+ * raptor_uri_shard_remove:
+ * @shard: URI table shard (locked)
+ * @uri: URI
+ *
+ * INTERNAL - Remove a URI from a URI table shard if present
+ *
+ * The following entries of the probe sequence are moved back into the
+ * gap so no deleted markers are needed.
+ */
+static void
+raptor_uri_shard_remove(raptor_uri_shard* shard, raptor_uri* uri)
+{
+  size_t mask = shard->size - 1;
+  size_t i;
+  size_t j;
+
+  for(i = uri->hash & mask; shard->slots[i] != uri; i = (i + 1) & mask) {
+    if(!shard->slots[i])
+      return;
+  }
+
+  j = i;
+  while(1) {
+    raptor_uri* moved;
+    size_t home;
+
+    j = (j + 1) & mask;
+    moved = shard->slots[j];
+    if(!moved)
+      break;
+
+    /* move the entry if its home slot is not cyclically in (i, j] */
+    home = moved->hash & mask;
+    if(i <= j ? (home <= i || home > j) : (home <= i && home > j)) {
+      shard->slots[i] = moved;
+      i = j;
+    }
+  }
+
+  shard->slots[i] = NULL;
+  shard->count--;
+}
+
+
 /**
  * raptor_new_uri_from_counted_string:
  * @world: raptor_world object
@@ -240,6 +502,8 @@ raptor_new_uri_from_counted_string(raptor_world* world,
 {
   raptor_uri* new_uri;
   unsigned char *new_string;
+  unsigned int hash;
+  raptor_uri_shard* shard = NULL;
   
   RAPTOR_CHECK_CONSTRUCTOR_WORLD(world);
 
@@ -251,24 +515,23 @@ raptor_new_uri_from_counted_string(raptor_world* world,
 
   raptor_world_open(world);
 
-  if(world->uris_tree) {
-    raptor_uri key; /* on stack - not allocated */
-
-    /* just to be safe */
-    memset(&key, 0, sizeof(key));
+  hash = raptor_uri_hash_string(uri_string, length);
 
-    key.string = (unsigned char*)uri_string;
-    key.length = (unsigned int)length;
+  if(world->uris_table) {
+    /* the shard stays locked until a new URI is added to it */
+    shard = RAPTOR_URI_TABLE_SHARD(world->uris_table, hash);
+    RAPTOR_MUTEX_LOCK(&shard->lock);
 
-    /* if existing URI found in tree, return it */
-    new_uri = (raptor_uri*)raptor_avltree_search(world->uris_tree, &key);
+    /* if existing URI found in table, return it */
+    new_uri = raptor_uri_shard_find(shard, uri_string,
+                                    (unsigned int)length, hash);
     if(new_uri) {
 #if defined(RAPTOR_DEBUG) && RAPTOR_DEBUG > 1
       RAPTOR_DEBUG3("Found existing URI %s with current usage %d\n",
                     uri_string, new_uri->usage);
 #endif
       
-      new_uri->usage++;
+      RAPTOR_ATOMIC_INCREMENT(&new_uri->usage);
       
       goto unlock;
     }
@@ -289,6 +552,7 @@ raptor_new_uri_from_counted_string(raptor_world* world,
 
   new_uri->world = world;
   new_uri->length = (unsigned int)length;
+  new_uri->hash = hash;
 
   if(1) {
     size_t alloc_len;
@@ -312,9 +576,9 @@ raptor_new_uri_from_counted_string(raptor_world* world,
 
   new_uri->usage = 1; /* for user */
 
-  /* store in tree */
-  if(world->uris_tree) {
-    if(raptor_avltree_add(world->uris_tree, new_uri)) {
+  /* store in table */
+  if(shard) {
+    if(raptor_uri_shard_add(shard, new_uri)) {
       RAPTOR_FREE(char*, new_string);
       RAPTOR_FREE(raptor_uri, new_uri);
       new_uri = NULL;
@@ -322,6 +586,8 @@ raptor_new_uri_from_counted_string(raptor_world* world,
   }
 
  unlock:
+  if(shard)
+    RAPTOR_MUTEX_UNLOCK(&shard->lock);
 
   return new_uri;
 }
@@ -671,24 +937,41 @@ raptor_new_uri_from_uri_or_file_string(raptor_world* world,
 void
 raptor_free_uri(raptor_uri *uri)
 {
+  int usage;
+
   if(!uri)
     return;
 
-  uri->usage--;
+  if(uri->world->uris_table) {
+    raptor_uri_shard* shard;
+
+    /* decrement usage without the lock while it cannot reach 0 */
+    usage = RAPTOR_ATOMIC_LOAD(&uri->usage);
+    while(usage > 1) {
+      if(RAPTOR_ATOMIC_COMPARE_AND_SWAP(&uri->usage, usage, usage - 1))
+        return;
+    }
+
+    /* otherwise hold the lock so the URI cannot be found again by
+     * raptor_new_uri_from_counted_string() while it is removed */
+    shard = RAPTOR_URI_TABLE_SHARD(uri->world->uris_table, uri->hash);
+    RAPTOR_MUTEX_LOCK(&shard->lock);
+    usage = RAPTOR_ATOMIC_DECREMENT(&uri->usage);
+    if(!usage)
+      raptor_uri_shard_remove(shard, uri);
+    RAPTOR_MUTEX_UNLOCK(&shard->lock);
+  } else
+    usage = RAPTOR_ATOMIC_DECREMENT(&uri->usage);
   
 #if defined(RAPTOR_DEBUG) && RAPTOR_DEBUG > 1
-  RAPTOR_DEBUG3("URI %s usage count now %d\n", uri->string, uri->usage);
+  RAPTOR_DEBUG3("URI %s usage count now %d\n", uri->string, usage);
 #endif
 
   /* decrement usage, don't free if not 0 yet*/
-  if(uri->usage > 0) {
+  if(usage > 0) {
     return;
   }
 
-  /* this does not free the uri */
-  if(uri->world->uris_tree)
-    raptor_avltree_delete(uri->world->uris_tree, uri);
-
   if(uri->string)
     RAPTOR_FREE(char*, uri->string);
   RAPTOR_FREE(raptor_uri, uri);
@@ -713,8 +996,8 @@ raptor_uri_equals(raptor_uri* uri1, raptor_uri* uri2)
     /* Both not-NULL - compare for equality */
     if(uri1 == uri2)
       return 1;
-    else if (uri1->length != uri2->length)
-      /* Different if lengths are different */
+    else if (uri1->length != uri2->length || uri1->hash != uri2->hash)
+      /* Different if lengths or hashes are different */
       return 0;
     else
       /* Same length compare: do not need strncmp() NUL checking */
@@ -778,7 +1061,7 @@ raptor_uri_copy(raptor_uri *uri)
 {
   RAPTOR_ASSERT_OBJECT_POINTER_RETURN_VALUE(uri, raptor_uri, NULL);
   
-  uri->usage++;
+  RAPTOR_ATOMIC_INCREMENT(&uri->usage);
   return uri;
 }
 
@@ -1452,15 +1735,14 @@ raptor_new_uri_for_retrieval(raptor_uri* old_uri)
 int
 raptor_uri_init(raptor_world* world)
 {
-  if(world->uri_interning && !world->uris_tree) {
-    world->uris_tree = raptor_new_avltree((raptor_data_compare_handler)raptor_uri_compare,
-                                          /* free */ NULL, 0);
-    if(!world->uris_tree) {
+  if(world->uri_interning && !world->uris_table) {
+    world->uris_table = raptor_new_uri_table();
+    if(!world->uris_table) {
 #ifdef RAPTOR_DEBUG
-      RAPTOR_FATAL1("Failed to create raptor URI avltree");
+      RAPTOR_FATAL1("Failed to create raptor URI table");
 #else
       raptor_log_error(world, RAPTOR_LOG_LEVEL_ERROR, NULL,
-                       "Failed to create raptor URI avltree");
+                       "Failed to create raptor URI table");
 #endif
     }
     
@@ -1473,9 +1755,9 @@ raptor_uri_init(raptor_world* world)
 void
 raptor_uri_finish(raptor_world* world)
 {
-  if(world->uris_tree) {
-    raptor_free_avltree(world->uris_tree);
-    world->uris_tree = NULL;
+  if(world->uris_table) {
+    raptor_free_uri_table(world->uris_table);
+    world->uris_table = NULL;
   }
 }
 
@@ -2142,6 +2424,56 @@ int main(int argc, char *argv[]);
 static const char *program;
 
 
+#if defined(HAVE_PTHREAD) && defined(HAVE_ATOMIC_BUILTINS)
+#define URI_TEST_THREADS 4
+#define URI_TEST_THREAD_URIS 500
+
+/* total number of URIs interned in @world */
+static size_t
+uri_test_interned_count(raptor_world* world)
+{
+  size_t count = 0;
+  int i;
+
+  for(i = 0; i < RAPTOR_URI_TABLE_SHARDS; i++)
+    count += world->uris_table->shards[i].count;
+
+  return count;
+}
+
+
+/* create, copy and free URIs and terms shared with other threads */
+static void*
+uri_test_thread(void* data)
+{
+  raptor_world* world = (raptor_world*)data;
+  raptor_term* terms[URI_TEST_THREAD_URIS];
+  int round;
+  int j;
+
+  for(round = 0; round < 20; round++) {
+    for(j = 0; j < URI_TEST_THREAD_URIS; j++) {
+      char buf[64];
+      raptor_uri* u;
+
+      snprintf(buf, sizeof(buf), "http://example.org/shared/%d", j);
+      u = raptor_new_uri(world, (const unsigned char*)buf);
+      terms[j] = raptor_new_term_from_uri(world, u);
+      raptor_free_uri(u);
+    }
+
+    for(j = 0; j < URI_TEST_THREAD_URIS; j++) {
+      raptor_term* t = raptor_term_copy(terms[j]);
+      raptor_free_term(terms[j]);
+      raptor_free_term(t);
+    }
+  }
+
+  return NULL;
+}
+#endif
+
+
 static int
 assert_uri_is_valid(raptor_uri* uri)
 {
@@ -2537,6 +2869,93 @@ main(int argc, char *argv[])
     raptor_free_uri(u2);
   }
 
+  /* interned URIs are shared, found again after the table grows and
+   * after other URIs in the same probe sequences are freed */
+  if(1) {
+#define URI_TEST_INTERN_COUNT 5000
+    raptor_uri** uris;
+    int j;
+
+    uris = RAPTOR_CALLOC(raptor_uri**, URI_TEST_INTERN_COUNT,
+                         sizeof(raptor_uri*));
+    if(!uris)
+      exit(1);
+
+    for(j = 0; j < URI_TEST_INTERN_COUNT; j++) {
+      char buf[64];
+      snprintf(buf, sizeof(buf), "http://example.org/resource/%d", j);
+      uris[j] = raptor_new_uri(world, (const unsigned char*)buf);
+    }
+
+    /* free every third URI */
+    for(j = 0; j < URI_TEST_INTERN_COUNT; j += 3) {
+      raptor_free_uri(uris[j]);
+      uris[j] = NULL;
+    }
+
+    for(j = 0; j < URI_TEST_INTERN_COUNT; j++) {
+      char buf[64];
+      raptor_uri* u;
+
+      snprintf(buf, sizeof(buf), "http://example.org/resource/%d", j);
+      u = raptor_new_uri(world, (const unsigned char*)buf);
+      if(!u || (uris[j] && u != uris[j]) ||
+         (uris[j] && !raptor_uri_equals(u, uris[j]))) {
+        fprintf(stderr, "%s: interned URI %s was not shared\n",
+                program, buf);
+        failures++;
+      }
+      if(j && raptor_uri_equals(u, uris[j - 1])) {
+        fprintf(stderr, "%s: raptor_uri_equals(%s, %s) returned equal\n",
+                program, buf, raptor_uri_as_string(uris[j - 1]));
+        failures++;
+      }
+      if(uris[j])
+        raptor_free_uri(u);
+      else
+        uris[j] = u;
+    }
+
+    for(j = 0; j < URI_TEST_INTERN_COUNT; j++)
+      raptor_free_uri(uris[j]);
+    RAPTOR_FREE(raptor_uri**, uris);
+  }
+
+#if defined(HAVE_PTHREAD) && defined(HAVE_ATOMIC_BUILTINS)
+  /* threads sharing the world intern the same URIs and leave the
+   * table as it was once they have freed them all */
+  if(world->uris_table) {
+    pthread_t threads[URI_TEST_THREADS];
+    raptor_uri* held;
+    size_t before;
+    int j;
+    int started = 0;
+
+    /* one URI stays held by this thread throughout */
+    held = raptor_new_uri(world,
+                          (const unsigned char*)"http://example.org/shared/0");
+    before = uri_test_interned_count(world);
+
+    for(j = 0; j < URI_TEST_THREADS; j++) {
+      if(!pthread_create(&threads[j], NULL, uri_test_thread, world))
+        started++;
+    }
+    for(j = 0; j < started; j++)
+      pthread_join(threads[j], NULL);
+
+    if(uri_test_interned_count(world) != before ||
+       raptor_uri_copy(held) != held || held->usage != 2) {
+      fprintf(stderr,
+              "%s: threads left %d interned URIs, expected %d; held URI usage %d, expected 2\n",
+              program, (int)uri_test_interned_count(world), (int)before,
+              held->usage);
+      failures++;
+    }
+    raptor_free_uri(held);
+    raptor_free_uri(held);
+  }
+#endif
+
   raptor_free_world(world);
 
   return failures ;
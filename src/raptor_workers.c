@@ -0,0 +1,530 @@
+/* -*- Mode: c; c-basic-offset: 2 -*-
+ *
+ * raptor_workers.c - Raptor worker thread pool
+ *
+ * Copyright (C) 2026, David Beckett http://www.dajobe.org/
+ *
+ * This package is Free Software and part of Redland http://librdf.org/
+ *
+ * It is licensed under the following three licenses as alternatives:
+ *   1. GNU Lesser General Public License (LGPL) V2.1 or any newer version
+ *   2. GNU General Public License (GPL) V2 or any newer version
+ *   3. Apache License, V2.0 or any newer version
+ *
+ * You may not use this file except in compliance with at least one of
+ * the above three licenses.
+ *
+ * See LICENSE.html or LICENSE.txt at the top of this package for the
+ * complete terms and further detail along with the license texts for
+ * the licenses in COPYING.LIB, COPYING and LICENSE-2.0.txt respectively.
+ *
+ *
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include <raptor_config.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+
+/* Raptor includes */
+#include "raptor2.h"
+#include "raptor_internal.h"
+
+
+/*
+ * A small fixed pool of threads running jobs for a single owner.
+ *
+ * Jobs are submitted and later collected by the same (owner) thread,
+ * either strictly in submission order or in whatever order they
+ * finish.  The job handlers run on the worker threads and must not
+ * touch any raptor object that the owner thread may also be using -
+ * in particular nothing that allocates from or logs to a
+ * #raptor_world.
+ *
+ * Without thread support raptor_new_workers() always fails and
+ * callers use their serial code.
+ */
+
+#ifdef HAVE_PTHREAD
+
+typedef struct raptor_workers_job_s raptor_workers_job;
+
+struct raptor_workers_job_s {
+  raptor_workers_job* next;
+
+  raptor_workers_job_handler handler;
+  void* data;
+
+  /* 0 queued, 1 running, 2 done */
+  int state;
+};
+
+
+struct raptor_workers_s {
+  pthread_mutex_t lock;
+  /* signalled when a job is queued or on shutdown */
+  pthread_cond_t job_queued;
+  /* signalled when a job is done */
+  pthread_cond_t job_done;
+
+  pthread_t* threads;
+  int threads_count;
+
+  /* all jobs not yet collected, oldest first */
+  raptor_workers_job* first;
+  raptor_workers_job* last;
+  int jobs_count;
+
+  /* first job in the list that has not been started */
+  raptor_workers_job* next_queued;
+
+  int shutdown;
+};
+
+
+static void*
+raptor_workers_thread(void* arg)
+{
+  raptor_workers* workers = (raptor_workers*)arg;
+
+  pthread_mutex_lock(&workers->lock);
+  while(1) {
+    raptor_workers_job* job;
+
+    while(!workers->next_queued && !workers->shutdown)
+      pthread_cond_wait(&workers->job_queued, &workers->lock);
+
+    if(!workers->next_queued)
+      break;
+
+    job = workers->next_queued;
+    workers->next_queued = job->next;
+    job->state = 1;
+
+    pthread_mutex_unlock(&workers->lock);
+    job->handler(job->data);
+    pthread_mutex_lock(&workers->lock);
+
+    job->state = 2;
+    pthread_cond_broadcast(&workers->job_done);
+  }
+  pthread_mutex_unlock(&workers->lock);
+
+  return NULL;
+}
+
+
+/*
+ * raptor_new_workers:
+ * @count: number of threads
+ *
+ * INTERNAL - Constructor - create a pool of worker threads
+ *
+ * Return value: new pool or NULL on failure or if threads are not
+ * supported
+ */
+raptor_workers*
+raptor_new_workers(int count)
+{
+  raptor_workers* workers;
+
+  if(count < 1)
+    return NULL;
+
+  workers = RAPTOR_CALLOC(raptor_workers*, 1, sizeof(*workers));
+  if(!workers)
+    return NULL;
+
+  workers->threads = RAPTOR_CALLOC(pthread_t*, RAPTOR_GOOD_CAST(size_t, count),
+                                   sizeof(pthread_t));
+  if(!workers->threads) {
+    RAPTOR_FREE(raptor_workers, workers);
+    return NULL;
+  }
+
+  pthread_mutex_init(&workers->lock, NULL);
+  pthread_cond_init(&workers->job_queued, NULL);
+  pthread_cond_init(&workers->job_done, NULL);
+
+  for(workers->threads_count = 0;
+      workers->threads_count < count;
+      workers->threads_count++) {
+    if(pthread_create(&workers->threads[workers->threads_count], NULL,
+                      raptor_workers_thread, workers))
+      break;
+  }
+
+  if(!workers->threads_count) {
+    raptor_free_workers(workers);
+    return NULL;
+  }
+
+  return workers;
+}
+
+
+/*
+ * raptor_free_workers:
+ * @workers: worker pool
+ *
+ * INTERNAL - Destructor - wait for running jobs then destroy the pool
+ *
+ * Jobs that have not been started are discarded without running.
+ * Job data of jobs never collected is not freed; the caller should
+ * collect all jobs with raptor_workers_next_done() first.
+ */
+void
+raptor_free_workers(raptor_workers* workers)
+{
+  raptor_workers_job* job;
+  int i;
+
+  if(!workers)
+    return;
+
+  pthread_mutex_lock(&workers->lock);
+  workers->shutdown = 1;
+  workers->next_queued = NULL;
+  pthread_cond_broadcast(&workers->job_queued);
+  pthread_mutex_unlock(&workers->lock);
+
+  for(i = 0; i < workers->threads_count; i++)
+    pthread_join(workers->threads[i], NULL);
+
+  for(job = workers->first; job; ) {
+    raptor_workers_job* next = job->next;
+    RAPTOR_FREE(raptor_workers_job, job);
+    job = next;
+  }
+
+  pthread_cond_destroy(&workers->job_done);
+  pthread_cond_destroy(&workers->job_queued);
+  pthread_mutex_destroy(&workers->lock);
+
+  RAPTOR_FREE(pthread_t*, workers->threads);
+  RAPTOR_FREE(raptor_workers, workers);
+}
+
+
+/*
+ * raptor_workers_get_count:
+ * @workers: worker pool
+ *
+ * INTERNAL - Get the number of threads in the pool
+ *
+ * Return value: number of threads
+ */
+int
+raptor_workers_get_count(raptor_workers* workers)
+{
+  return workers->threads_count;
+}
+
+
+/*
+ * raptor_workers_submit:
+ * @workers: worker pool
+ * @handler: function to run on a worker thread
+ * @data: job data passed to @handler
+ *
+ * INTERNAL - Queue a job to run on a worker thread
+ *
+ * Return value: non-0 on failure
+ */
+int
+raptor_workers_submit(raptor_workers* workers,
+                      raptor_workers_job_handler handler, void* data)
+{
+  raptor_workers_job* job;
+
+  job = RAPTOR_CALLOC(raptor_workers_job*, 1, sizeof(*job));
+  if(!job)
+    return 1;
+
+  job->handler = handler;
+  job->data = data;
+
+  pthread_mutex_lock(&workers->lock);
+  if(workers->last)
+    workers->last->next = job;
+  else
+    workers->first = job;
+  workers->last = job;
+  workers->jobs_count++;
+
+  if(!workers->next_queued)
+    workers->next_queued = job;
+
+  pthread_cond_signal(&workers->job_queued);
+  pthread_mutex_unlock(&workers->lock);
+
+  return 0;
+}
+
+
+/*
+ * raptor_workers_get_pending:
+ * @workers: worker pool
+ *
+ * INTERNAL - Get the number of submitted jobs not yet collected
+ *
+ * Return value: number of jobs
+ */
+int
+raptor_workers_get_pending(raptor_workers* workers)
+{
+  int count;
+
+  pthread_mutex_lock(&workers->lock);
+  count = workers->jobs_count;
+  pthread_mutex_unlock(&workers->lock);
+
+  return count;
+}
+
+
+/*
+ * raptor_workers_next_done:
+ * @workers: worker pool
+ * @ordered: non-0 to return jobs in submission order
+ * @wait: non-0 to block until a job is done
+ *
+ * INTERNAL - Collect a finished job
+ *
+ * If @ordered is set, only the oldest job can be returned, otherwise
+ * the oldest of the finished jobs is returned.
+ *
+ * Return value: the job data of a finished job or NULL if there are
+ * no jobs or none was finished and @wait was 0
+ */
+void*
+raptor_workers_next_done(raptor_workers* workers, int ordered, int wait)
+{
+  raptor_workers_job* job = NULL;
+  raptor_workers_job* prev = NULL;
+  void* data = NULL;
+
+  pthread_mutex_lock(&workers->lock);
+  while(workers->first) {
+    prev = NULL;
+    for(job = workers->first; job; prev = job, job = job->next) {
+      if(job->state == 2 || ordered)
+        break;
+    }
+
+    if(job && job->state == 2)
+      break;
+
+    job = NULL;
+    if(!wait)
+      break;
+
+    pthread_cond_wait(&workers->job_done, &workers->lock);
+  }
+
+  if(job) {
+    if(prev)
+      prev->next = job->next;
+    else
+      workers->first = job->next;
+    if(workers->last == job)
+      workers->last = prev;
+    workers->jobs_count--;
+  }
+  pthread_mutex_unlock(&workers->lock);
+
+  if(job) {
+    data = job->data;
+    RAPTOR_FREE(raptor_workers_job, job);
+  }
+
+  return data;
+}
+
+
+#else
+
+/* No thread support; every caller falls back to running serially */
+
+raptor_workers*
+raptor_new_workers(int count)
+{
+  return NULL;
+}
+
+
+void
+raptor_free_workers(raptor_workers* workers)
+{
+}
+
+
+int
+raptor_workers_get_count(raptor_workers* workers)
+{
+  return 0;
+}
+
+
+int
+raptor_workers_submit(raptor_workers* workers,
+                      raptor_workers_job_handler handler, void* data)
+{
+  return 1;
+}
+
+
+int
+raptor_workers_get_pending(raptor_workers* workers)
+{
+  return 0;
+}
+
+
+void*
+raptor_workers_next_done(raptor_workers* workers, int ordered, int wait)
+{
+  return NULL;
+}
+
+#endif
+
+
+
+#ifdef STANDALONE
+
+/* one more prototype */
+int main(int argc, char *argv[]);
+
+
+#define WORKERS_TEST_JOBS 200
+
+typedef struct {
+  int index;
+  unsigned long result;
+} workers_test_job;
+
+
+static void
+workers_test_handler(void* data)
+{
+  workers_test_job* job = (workers_test_job*)data;
+  unsigned long i;
+  unsigned long sum = 0;
+
+  /* uneven amounts of work so jobs finish out of order */
+  for(i = 0; i < (unsigned long)((job->index * 7919) % 5000); i++)
+    sum += i;
+  job->result = sum;
+}
+
+
+int
+main(int argc, char *argv[])
+{
+  const char *program = raptor_basename(argv[0]);
+  workers_test_job jobs[WORKERS_TEST_JOBS];
+  int seen[WORKERS_TEST_JOBS];
+  raptor_workers* workers;
+  int ordered;
+  int failures = 0;
+
+  workers = raptor_new_workers(4);
+#ifdef HAVE_PTHREAD
+  if(!workers) {
+    fprintf(stderr, "%s: raptor_new_workers() failed\n", program);
+    return 1;
+  }
+#else
+  if(workers) {
+    fprintf(stderr, "%s: raptor_new_workers() without threads returned a pool\n", program);
+    return 1;
+  }
+  return 0;
+#endif
+
+  for(ordered = 1; ordered >= 0; ordered--) {
+    int i;
+    int collected = 0;
+    int expected_index = 0;
+
+    memset(seen, '\0', sizeof(seen));
+    for(i = 0; i < WORKERS_TEST_JOBS; i++) {
+      jobs[i].index = i;
+      jobs[i].result = 0;
+      if(raptor_workers_submit(workers, workers_test_handler, &jobs[i])) {
+        fprintf(stderr, "%s: raptor_workers_submit() failed\n", program);
+        return 1;
+      }
+
+      /* collect some as we go without blocking */
+      if(i % 3 == 0) {
+        workers_test_job* job;
+        job = (workers_test_job*)raptor_workers_next_done(workers, ordered, 0);
+        if(job) {
+          if(ordered && job->index != expected_index++) {
+            fprintf(stderr, "%s: ordered job %d returned out of order\n",
+                    program, job->index);
+            failures++;
+          }
+          seen[job->index]++;
+          collected++;
+        }
+      }
+    }
+
+    while(raptor_workers_get_pending(workers)) {
+      workers_test_job* job;
+      job = (workers_test_job*)raptor_workers_next_done(workers, ordered, 1);
+      if(!job) {
+        fprintf(stderr, "%s: raptor_workers_next_done() returned no job with %d pending\n",
+                program, raptor_workers_get_pending(workers));
+        return 1;
+      }
+      if(ordered && job->index != expected_index++) {
+        fprintf(stderr, "%s: ordered job %d returned out of order\n",
+                program, job->index);
+        failures++;
+      }
+      seen[job->index]++;
+      collected++;
+    }
+
+    if(collected != WORKERS_TEST_JOBS) {
+      fprintf(stderr, "%s: collected %d jobs expected %d\n", program,
+              collected, WORKERS_TEST_JOBS);
+      failures++;
+    }
+
+    for(i = 0; i < WORKERS_TEST_JOBS; i++) {
+      unsigned long n = (unsigned long)((i * 7919) % 5000);
+      unsigned long expected = n ? n * (n - 1) / 2 : 0;
+      if(seen[i] != 1 || jobs[i].result != expected) {
+        fprintf(stderr, "%s: job %d seen %d times with result %lu expected %lu\n",
+                program, i, seen[i], jobs[i].result, expected);
+        failures++;
+      }
+    }
+  }
+
+  if(raptor_workers_next_done(workers, 0, 1)) {
+    fprintf(stderr, "%s: raptor_workers_next_done() returned a job when empty\n",
+            program);
+    failures++;
+  }
+
+  raptor_free_workers(workers);
+
+  return failures;
+}
+
+#endif
@@ -53,15 +53,16 @@
 #include <turtle_common.h>
 
 /**
- * raptor_stringbuffer_append_turtle_string:
- * @stringbuffer: String buffer to add to
+ * raptor_turtle_decode_string:
  * @text: turtle string to decode
  * @len: length of string
  * @delim: terminating delimiter for string - only ', " or &gt; are allowed
  * @error_handler: error handling function
  * @error_data: error handler data
+ * @is_uri: non-0 if the string is a URI
+ * @len_p: pointer to store the length of the decoded string
  *
- * Append to a stringbuffer a Turtle-escaped string.
+ * Decode a Turtle-escaped string into a new string.
  *
  * The passed in string is handled according to the Turtle string
  * escape rules giving a UTF-8 encoded output of the Unicode codepoints.
@@ -73,15 +74,16 @@
  *
  * URIs may not have \t \b \n \r \f or raw ' ' or \u0020 or \u003C or \u003E
  *
- * Return value: non-0 on failure
+ * The decoded string is never longer than @text so it is decoded
+ * straight into its final allocation, which the caller owns and can
+ * hand on to a term or URI without another copy.
+ *
+ * Return value: new NUL terminated string or NULL on failure
  **/
-int
-raptor_stringbuffer_append_turtle_string(raptor_stringbuffer* stringbuffer,
-                                         const unsigned char *text,
-                                         size_t len, int delim,
-                                         raptor_simple_message_handler error_handler, 
-                                         void *error_data,
-                                         int is_uri)
+unsigned char*
+raptor_turtle_decode_string(const unsigned char *text, size_t len, int delim,
+                            raptor_simple_message_handler error_handler,
+                            void *error_data, int is_uri, size_t *len_p)
 {
   size_t i;
   const unsigned char *s;
@@ -90,7 +92,7 @@ raptor_stringbuffer_append_turtle_string(raptor_stringbuffer* stringbuffer,
   const char* label = (is_uri ? "URI" : "string");
 
   if(!string)
-    return -1;
+    return NULL;
 
   for(s = text, d = string, i = 0; i < len; s++, i++) {
     unsigned char c=*s;
@@ -99,7 +101,7 @@ raptor_stringbuffer_append_turtle_string(raptor_stringbuffer* stringbuffer,
       error_handler(error_data,
                     "Turtle %s error - character '%c'", label, c);
       RAPTOR_FREE(char*, string);
-      return 1;
+      return NULL;
     }
 
     if(c == '\\' ) {
@@ -110,7 +112,7 @@ raptor_stringbuffer_append_turtle_string(raptor_stringbuffer* stringbuffer,
           error_handler(error_data,
                         "Turtle %s error - illegal URI escape '\\%c'", label, c);
           RAPTOR_FREE(char*, string);
-          return 1;
+          return NULL;
         }
         if(c == 'n')
           *d++ = '\n';
@@ -140,7 +142,7 @@ raptor_stringbuffer_append_turtle_string(raptor_stringbuffer* stringbuffer,
           error_handler(error_data,
                         "Turtle %s error - \\%c over end of line", label, c);
           RAPTOR_FREE(char*, string);
-          return 1;
+          return NULL;
         }
 
         for(ii = 0; ii < ulen; ii++) {
@@ -150,7 +152,7 @@ raptor_stringbuffer_append_turtle_string(raptor_stringbuffer* stringbuffer,
                           "Turtle %s error - illegal hex digit %c in Unicode escape '%c%s...'",
                           label, cc, c, s);
             RAPTOR_FREE(char*, string);
-            return 1;
+            return NULL;
           }
         }
 
@@ -160,7 +162,7 @@ raptor_stringbuffer_append_turtle_string(raptor_stringbuffer* stringbuffer,
                         "Turtle %s error - illegal Unicode escape '%c%s...'",
                         label, c, s);
           RAPTOR_FREE(char*, string);
-          return 1;
+          return NULL;
         }
 
         s+= ulen-1;
@@ -177,7 +179,7 @@ raptor_stringbuffer_append_turtle_string(raptor_stringbuffer* stringbuffer,
                         "Turtle %s error - illegal Unicode character with code point #x%lX (max #x%lX).", 
                         label, unichar, raptor_unicode_max_codepoint);
           RAPTOR_FREE(char*, string);
-          return 1;
+          return NULL;
         }
           
         unichar_width = raptor_unicode_utf8_string_put_char(unichar, d, 
@@ -187,7 +189,7 @@ raptor_stringbuffer_append_turtle_string(raptor_stringbuffer* stringbuffer,
                         "Turtle %s error - illegal Unicode character with code point #x%lX.", 
                         label, unichar);
           RAPTOR_FREE(char*, string);
-          return 1;
+          return NULL;
         }
         d += (size_t)unichar_width;
 
@@ -197,7 +199,7 @@ raptor_stringbuffer_append_turtle_string(raptor_stringbuffer* stringbuffer,
                       "Turtle %s error - illegal escape \\%c (#x%02X) in \"%s\"", 
                       label, c, c, text);
         RAPTOR_FREE(char*, string);
-        return 1;
+        return NULL;
       }
     } else
       *d++=c;
@@ -205,7 +207,42 @@ raptor_stringbuffer_append_turtle_string(raptor_stringbuffer* stringbuffer,
   *d='\0';
 
   /* calculate output string size */
-  len = d-string;
+  *len_p = RAPTOR_GOOD_CAST(size_t, d - string);
+
+  return string;
+}
+
+
+/**
+ * raptor_stringbuffer_append_turtle_string:
+ * @stringbuffer: String buffer to add to
+ * @text: turtle string to decode
+ * @len: length of string
+ * @delim: terminating delimiter for string - only ', " or &gt; are allowed
+ * @error_handler: error handling function
+ * @error_data: error handler data
+ * @is_uri: non-0 if the string is a URI
+ *
+ * Append to a stringbuffer a Turtle-escaped string.
+ *
+ * See raptor_turtle_decode_string() for the escapes handled.
+ *
+ * Return value: non-0 on failure
+ **/
+int
+raptor_stringbuffer_append_turtle_string(raptor_stringbuffer* stringbuffer,
+                                         const unsigned char *text,
+                                         size_t len, int delim,
+                                         raptor_simple_message_handler error_handler, 
+                                         void *error_data,
+                                         int is_uri)
+{
+  unsigned char *string;
+
+  string = raptor_turtle_decode_string(text, len, delim, error_handler,
+                                       error_data, is_uri, &len);
+  if(!string)
+    return 1;
 
   if(!len) {
     RAPTOR_FREE(char*, string);
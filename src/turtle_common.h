@@ -43,6 +43,19 @@ RAPTOR_INTERNAL_API size_t raptor_turtle_expand_qname_escapes(unsigned char *nam
 
 /* turtle_lexer.l */
 extern void turtle_token_free(raptor_world* world, int token, TURTLE_PARSER_STYPE *lval);
+void turtle_lexer_syntax_error(void* ctx, const char *message, ...) RAPTOR_PRINTF_FORMAT(2, 3);
+
+/* turtle_scanner.c */
+typedef struct turtle_scanner_s turtle_scanner;
+
+RAPTOR_INTERNAL_API turtle_scanner* turtle_new_scanner(raptor_parser* rdf_parser);
+RAPTOR_INTERNAL_API void turtle_free_scanner(turtle_scanner* scanner);
+RAPTOR_INTERNAL_API int turtle_scanner_append(turtle_scanner* scanner, const unsigned char *buffer, size_t len);
+RAPTOR_INTERNAL_API int turtle_scanner_lex(turtle_scanner* scanner, TURTLE_PARSER_STYPE *lval, int is_end);
+
+
+/* turtle_parser.y - parallel parsing state */
+typedef struct raptor_turtle_split_s raptor_turtle_split;
 
 
 /*
@@ -60,7 +73,8 @@ struct raptor_turtle_parser_s {
   /* for lexer to store result in */
   TURTLE_PARSER_STYPE lval;
 
-  /* STATIC lexer */
+  /* STATIC lexer: flex scanner or turtle_scanner* if
+   * RAPTOR_TURTLE_SCANNER is defined */
   yyscan_t scanner;
 
   int scanner_set;
@@ -82,6 +96,10 @@ struct raptor_turtle_parser_s {
 
   /* Allow TRIG extensions */
   int trig;
+
+  /* parallel parsing: statement splitting and worker threads or NULL
+   * when parsing serially */
+  raptor_turtle_split* split;
 };
 
 
@@ -111,6 +111,8 @@ static void raptor_turtle_defer_statement(raptor_parser *parser, raptor_statemen
 
 static void raptor_turtle_handle_statement(raptor_parser *parser, raptor_statement *triple);
 
+static void raptor_free_turtle_split(raptor_turtle_split* split);
+
 %}
 
 
@@ -890,9 +892,10 @@ literal: STRING_LITERAL LANGTAG
   printf("literal + language string=\"%s\"\n", $1);
 #endif
 
-  $$ = raptor_new_term_from_literal(PARSER_FROM_FSP_CONTEXT(fsp_ctx)->world, $1, NULL, $2);
-  RAPTOR_FREE(char*, $1);
-  RAPTOR_FREE(char*, $2);
+  /* the term takes the token strings */
+  $$ = raptor_new_term_from_counted_literal_owned(PARSER_FROM_FSP_CONTEXT(fsp_ctx)->world,
+                                                  $1, strlen((const char*)$1),
+                                                  NULL, $2);
   if(!$$)
     YYERROR;
 }
@@ -933,13 +936,15 @@ literal: STRING_LITERAL LANGTAG
 #endif
 
   if($3) {
-    $$ = raptor_new_term_from_literal(PARSER_FROM_FSP_CONTEXT(fsp_ctx)->world, $1, $3, NULL);
-    RAPTOR_FREE(char*, $1);
-    raptor_free_uri($3);
+    $$ = raptor_new_term_from_counted_literal_owned(PARSER_FROM_FSP_CONTEXT(fsp_ctx)->world,
+                                                    $1, strlen((const char*)$1),
+                                                    $3, NULL);
     if(!$$)
       YYERROR;
-  } else
+  } else {
+    RAPTOR_FREE(char*, $1);
     $$ = NULL;
+  }
     
 }
 | STRING_LITERAL HAT QNAME_LITERAL
@@ -949,13 +954,15 @@ literal: STRING_LITERAL LANGTAG
 #endif
 
   if($3) {
-    $$ = raptor_new_term_from_literal(PARSER_FROM_FSP_CONTEXT(fsp_ctx)->world, $1, $3, NULL);
-    RAPTOR_FREE(char*, $1);
-    raptor_free_uri($3);
+    $$ = raptor_new_term_from_counted_literal_owned(PARSER_FROM_FSP_CONTEXT(fsp_ctx)->world,
+                                                    $1, strlen((const char*)$1),
+                                                    $3, NULL);
     if(!$$)
       YYERROR;
-  } else
+  } else {
+    RAPTOR_FREE(char*, $1);
     $$ = NULL;
+  }
 }
 | STRING_LITERAL
 {
@@ -963,8 +970,9 @@ literal: STRING_LITERAL LANGTAG
   printf("literal string=\"%s\"\n", $1);
 #endif
 
-  $$ = raptor_new_term_from_literal(PARSER_FROM_FSP_CONTEXT(fsp_ctx)->world, $1, NULL, NULL);
-  RAPTOR_FREE(char*, $1);
+  $$ = raptor_new_term_from_counted_literal_owned(PARSER_FROM_FSP_CONTEXT(fsp_ctx)->world,
+                                                  $1, strlen((const char*)$1),
+                                                  NULL, NULL);
   if(!$$)
     YYERROR;
 }
@@ -975,9 +983,9 @@ literal: STRING_LITERAL LANGTAG
   printf("resource integer=%s\n", $1);
 #endif
   uri = raptor_uri_copy(PARSER_FROM_FSP_CONTEXT(fsp_ctx)->world->xsd_integer_uri);
-  $$ = raptor_new_term_from_literal(PARSER_FROM_FSP_CONTEXT(fsp_ctx)->world, $1, uri, NULL);
-  RAPTOR_FREE(char*, $1);
-  raptor_free_uri(uri);
+  $$ = raptor_new_term_from_counted_literal_owned(PARSER_FROM_FSP_CONTEXT(fsp_ctx)->world,
+                                                  $1, strlen((const char*)$1),
+                                                  uri, NULL);
   if(!$$)
     YYERROR;
 }
@@ -988,9 +996,9 @@ literal: STRING_LITERAL LANGTAG
   printf("resource double=%s\n", $1);
 #endif
   uri = raptor_uri_copy(PARSER_FROM_FSP_CONTEXT(fsp_ctx)->world->xsd_double_uri);
-  $$ = raptor_new_term_from_literal(PARSER_FROM_FSP_CONTEXT(fsp_ctx)->world, $1, uri, NULL);
-  RAPTOR_FREE(char*, $1);
-  raptor_free_uri(uri);
+  $$ = raptor_new_term_from_counted_literal_owned(PARSER_FROM_FSP_CONTEXT(fsp_ctx)->world,
+                                                  $1, strlen((const char*)$1),
+                                                  uri, NULL);
   if(!$$)
     YYERROR;
 }
@@ -1005,9 +1013,9 @@ literal: STRING_LITERAL LANGTAG
     RAPTOR_FREE(char*, $1);
     YYERROR;
   }
-  $$ = raptor_new_term_from_literal(PARSER_FROM_FSP_CONTEXT(fsp_ctx)->world, $1, uri, NULL);
-  RAPTOR_FREE(char*, $1);
-  raptor_free_uri(uri);
+  $$ = raptor_new_term_from_counted_literal_owned(PARSER_FROM_FSP_CONTEXT(fsp_ctx)->world,
+                                                  $1, strlen((const char*)$1),
+                                                  uri, NULL);
   if(!$$)
     YYERROR;
 }
@@ -1084,7 +1092,7 @@ predicateObjectListOpt: predicateObjectList
 
 blankNode: BLANK_LITERAL
 {
-  const unsigned char *id;
+  unsigned char *id;
 #if defined(RAPTOR_DEBUG) && RAPTOR_DEBUG > 1  
   printf("subject blank=\"%s\"\n", $1);
 #endif
@@ -1092,9 +1100,8 @@ blankNode: BLANK_LITERAL
   if(!id)
     YYERROR;
 
-  $$ = raptor_new_term_from_blank(PARSER_FROM_FSP_CONTEXT(fsp_ctx)->world, id);
-  RAPTOR_FREE(char*, id);
-
+  $$ = raptor_new_term_from_counted_blank_owned(PARSER_FROM_FSP_CONTEXT(fsp_ctx)->world,
+                                                id, strlen((const char*)id));
   if(!$$)
     YYERROR;
 }
@@ -1103,7 +1110,7 @@ blankNode: BLANK_LITERAL
 blankNodePropertyList: LEFT_SQUARE predicateObjectListOpt RIGHT_SQUARE
 {
   int i;
-  const unsigned char *id;
+  unsigned char *id;
 
   id = raptor_world_generate_bnodeid(PARSER_FROM_FSP_CONTEXT(fsp_ctx)->world);
   if(!id) {
@@ -1112,8 +1119,8 @@ blankNodePropertyList: LEFT_SQUARE predicateObjectListOpt RIGHT_SQUARE
     YYERROR;
   }
 
-  $$ = raptor_new_term_from_blank(PARSER_FROM_FSP_CONTEXT(fsp_ctx)->world, id);
-  RAPTOR_FREE(char*, id);
+  $$ = raptor_new_term_from_counted_blank_owned(PARSER_FROM_FSP_CONTEXT(fsp_ctx)->world,
+                                                id, strlen((const char*)id));
   if(!$$) {
     if($2)
       raptor_free_sequence($2);
@@ -1191,15 +1198,15 @@ collection: LEFT_ROUND itemList RIGHT_ROUND
   for(i = raptor_sequence_size($2)-1; i>=0; i--) {
     raptor_term* temp;
     raptor_statement* t2 = (raptor_statement*)raptor_sequence_get_at($2, i);
-    const unsigned char *blank_id;
+    unsigned char *blank_id;
 
     blank_id = raptor_world_generate_bnodeid(PARSER_FROM_FSP_CONTEXT(fsp_ctx)->world);
     if(!blank_id)
       YYERR_MSG_GOTO(err_collection, "Cannot create bnodeid");
 
-    blank = raptor_new_term_from_blank(PARSER_FROM_FSP_CONTEXT(fsp_ctx)->world,
-                                       blank_id);
-    RAPTOR_FREE(char*, blank_id);
+    blank = raptor_new_term_from_counted_blank_owned(PARSER_FROM_FSP_CONTEXT(fsp_ctx)->world,
+                                                     blank_id,
+                                                     strlen((const char*)blank_id));
     if(!blank)
       YYERR_MSG_GOTO(err_collection, "Cannot create bnode");
     
@@ -1385,7 +1392,8 @@ turtle_qname_to_uri(raptor_parser *rdf_parser, unsigned char *name, size_t name_
  * @scanner: Lexer scanner
  *
  * Process tokens from lexer and push them to Bison push parser.
- * Uses libfsp for buffer management and streaming.
+ * Uses libfsp for buffer management and streaming, or the scanner's
+ * own buffer when built with the hand-written scanner.
  * The parser state (pstate) persists across chunks.
  *
  * Return value: 0 on success, non-0 on failure
@@ -1399,6 +1407,7 @@ turtle_push_parse(fsp_context *fsp_ctx, yyscan_t scanner)
   int rc = 0;
   int is_end = !fsp_ctx->more_chunks_expected;
 
+#ifndef RAPTOR_TURTLE_SCANNER
   /* Minimum bytes needed in FSP buffer before calling lexer.
    * Determined by libfsp fsp-helper.py analysis of turtle_lexer.l:
    * - Longest fixed-length token: [Pp][Rr][Ee][Ff][Ii][Xx] = 6 bytes
@@ -1408,6 +1417,7 @@ turtle_push_parse(fsp_context *fsp_ctx, yyscan_t scanner)
    *   - Performance (reduces "need more data" frequency)
    */
   #define MIN_BUFFER_FOR_LEX 16
+#endif
 
   /* Create push parser state on first call */
   if(!pstate) {
@@ -1419,19 +1429,24 @@ turtle_push_parse(fsp_context *fsp_ctx, yyscan_t scanner)
   }
 
   /* Process tokens while we have enough buffer or at EOF */
-  while(fsp_buffer_available(fsp_ctx) >= MIN_BUFFER_FOR_LEX || is_end) {
+  while(1) {
     TURTLE_PARSER_STYPE lval;
     int token;
 
     /* Get next token from lexer */
+#ifdef RAPTOR_TURTLE_SCANNER
+    /* the scanner holds back a token that may continue in the next
+     * chunk so needs no minimum */
+    token = turtle_scanner_lex((turtle_scanner*)scanner, &lval, is_end);
+#else
+    if(!is_end && fsp_buffer_available(fsp_ctx) < MIN_BUFFER_FOR_LEX)
+      break;
+
     token = turtle_lexer_lex(&lval, scanner);
+#endif
 
     if(!token) {
       /* No more tokens from lexer */
-      if(!is_end && fsp_buffer_available(fsp_ctx) < MIN_BUFFER_FOR_LEX) {
-        /* Need more data - return success for now */
-        return 0;
-      }
       /* At EOF - push EOF token (0) to parser to finalize parsing */
       if(is_end) {
         rc = turtle_parser_push_parse(pstate, 0, NULL, fsp_ctx, scanner);
@@ -1440,7 +1455,7 @@ turtle_push_parse(fsp_context *fsp_ctx, yyscan_t scanner)
         }
         return rc;
       }
-      /* No more tokens but not EOF yet */
+      /* Need more data - return success for now */
       return 0;
     }
 
@@ -1476,6 +1491,10 @@ raptor_turtle_parse_init(raptor_parser* rdf_parser, const char *name) {
   if(raptor_namespaces_init(rdf_parser->world, &turtle_parser->namespaces, 0))
     return 1;
 
+  /* prefixed names are expanded once per @prefix binding */
+  if(raptor_namespaces_enable_qname_cache(&turtle_parser->namespaces))
+    return 1;
+
   turtle_parser->trig = !strcmp(name, "trig");
 
   return 0;
@@ -1496,7 +1515,11 @@ raptor_turtle_parse_terminate(raptor_parser *rdf_parser) {
   raptor_namespaces_clear(&turtle_parser->namespaces);
 
   if(turtle_parser->scanner_set) {
+#ifdef RAPTOR_TURTLE_SCANNER
+    turtle_free_scanner((turtle_scanner*)turtle_parser->scanner);
+#else
     turtle_lexer_lex_destroy(turtle_parser->scanner);
+#endif
     turtle_parser->scanner_set = 0;
   }
 
@@ -1514,6 +1537,11 @@ raptor_turtle_parse_terminate(raptor_parser *rdf_parser) {
     raptor_free_term(turtle_parser->graph_name);
     turtle_parser->graph_name = NULL;
   }
+
+  if(turtle_parser->split) {
+    raptor_free_turtle_split(turtle_parser->split);
+    turtle_parser->split = NULL;
+  }
 }
 
 
@@ -1535,17 +1563,15 @@ raptor_turtle_clone_statement(raptor_parser *parser, raptor_statement *t)
     parser->emitted_default_graph++;
   }
   
+  /* The grammar terms are usage counted and never changed after they
+   * are made so the statement shares them rather than copying them
+   */
+
   /* Two choices for subject for Turtle */
-  if(t->subject->type == RAPTOR_TERM_TYPE_BLANK) {
-    statement->subject = raptor_new_term_from_blank(parser->world,
-                                                    t->subject->value.blank.string);
-  } else {
-    /* RAPTOR_TERM_TYPE_URI */
-    RAPTOR_ASSERT(t->subject->type != RAPTOR_TERM_TYPE_URI,
-                  "subject type is not resource");
-    statement->subject = raptor_new_term_from_uri(parser->world,
-                                                  t->subject->value.uri);
-  }
+  RAPTOR_ASSERT(t->subject->type != RAPTOR_TERM_TYPE_BLANK &&
+                t->subject->type != RAPTOR_TERM_TYPE_URI,
+                "subject type is not resource");
+  statement->subject = raptor_term_copy(t->subject);
 
   /* Predicates are URIs but check for bad ordinals */
   if(!strncmp((const char*)raptor_uri_as_string(t->predicate->value.uri),
@@ -1556,26 +1582,10 @@ raptor_turtle_clone_statement(raptor_parser *parser, raptor_statement *t)
       raptor_parser_error(parser, "Illegal ordinal value %d in property '%s'.", predicate_ordinal, predicate_uri_string);
   }
   
-  statement->predicate = raptor_new_term_from_uri(parser->world,
-                                                  t->predicate->value.uri);
-  
+  statement->predicate = raptor_term_copy(t->predicate);
 
-  /* Three choices for object for Turtle */
-  if(t->object->type == RAPTOR_TERM_TYPE_URI) {
-    statement->object = raptor_new_term_from_uri(parser->world,
-                                                 t->object->value.uri);
-  } else if(t->object->type == RAPTOR_TERM_TYPE_BLANK) {
-    statement->object = raptor_new_term_from_blank(parser->world,
-                                                   t->object->value.blank.string);
-  } else {
-    /* RAPTOR_TERM_TYPE_LITERAL */
-    RAPTOR_ASSERT(t->object->type != RAPTOR_TERM_TYPE_LITERAL,
-                  "object type is not literal");
-    statement->object = raptor_new_term_from_literal(parser->world,
-                                                     t->object->value.literal.string,
-                                                     t->object->value.literal.datatype,
-                                                     t->object->value.literal.language);
-  }
+  /* Three choices for object for Turtle: URI, blank node or literal */
+  statement->object = raptor_term_copy(t->object);
 }
 
 static void
@@ -1584,11 +1594,11 @@ raptor_turtle_handle_statement(raptor_parser *parser, raptor_statement *t)
   if(!t->subject || !t->predicate || !t->object)
     return;
 
-  if(!parser->statement_handler)
+  if(!RAPTOR_PARSER_HAS_STATEMENT_HANDLER(parser))
     return;
 
   /* Generate the statement */
-  (*parser->statement_handler)(parser->user_data, t);
+  raptor_parser_emit_statement(parser, t);
 }
 
 static void
@@ -1635,7 +1645,7 @@ raptor_turtle_defer_statement(raptor_parser *parser, raptor_statement *t)
 
 
 /**
- * raptor_turtle_parse_chunk - Parse a chunk of Turtle/TriG using libfsp streaming
+ * raptor_turtle_parse_serial_chunk - Parse a chunk of Turtle/TriG using libfsp streaming
  * @rdf_parser: Raptor parser
  * @s: Input buffer
  * @len: Length of input
@@ -1646,9 +1656,9 @@ raptor_turtle_defer_statement(raptor_parser *parser, raptor_statement *t)
  * Return value: 0 on success, non-0 on failure
  */
 static int
-raptor_turtle_parse_chunk(raptor_parser *rdf_parser, 
-                          const unsigned char *s, size_t len,
-                          int is_end)
+raptor_turtle_parse_serial_chunk(raptor_parser *rdf_parser, 
+                                 const unsigned char *s, size_t len,
+                                 int is_end)
 {
   raptor_turtle_parser *turtle_parser = (raptor_turtle_parser*)rdf_parser->context;
   fsp_context *fsp_ctx = turtle_parser->fsp_ctx;
@@ -1671,8 +1681,13 @@ raptor_turtle_parse_chunk(raptor_parser *rdf_parser,
 
   /* Append chunk to FSP buffer */
   if(len > 0) {
+#ifdef RAPTOR_TURTLE_SCANNER
+    if(turtle_scanner_append((turtle_scanner*)turtle_parser->scanner, s, len))
+      return 1;
+#else
     if(fsp_buffer_append(fsp_ctx, (const char*)s, len) < 0)
       return 1;
+#endif
   }
 
   /* Signal EOF to FSP if this is the final chunk */
@@ -1704,6 +1719,1144 @@ raptor_turtle_parse_chunk(raptor_parser *rdf_parser,
 }
 
 
+/*
+ * Parallel parsing
+ *
+ * With RAPTOR_OPTION_PARSE_THREADS > 1 a Turtle (not TriG) parse
+ * splits the input after the '.' that ends each statement, found by a
+ * scan that follows IRIs, strings, comments and bracket nesting but
+ * does not tokenize.  Runs of triples statements are copied into a
+ * segment that is parsed on a worker thread by a new Turtle parser.
+ * That parser first reads the directives seen so far (the prologue)
+ * so it has the same prefixes and base URI.  The parser thread
+ * returns the statements of each segment in document order.
+ *
+ * Directives are parsed on the parser thread, after the statements of
+ * all earlier segments are returned, so the namespace handler is
+ * called in document order.  PREFIX and BASE end with an IRI that the
+ * lexer returns only once it sees the next token, so the statement
+ * after them is parsed on the parser thread too and the prologue gets
+ * the equivalent @prefix or @base form.
+ *
+ * Anything the scan cannot split - '{', '}', unbalanced brackets or a
+ * statement left open at the end of the input - and any segment whose
+ * parse logged a message or declared a prefix or base URI switches to
+ * parsing the rest of the input serially from the start of that
+ * segment, so errors and warnings are reported exactly as before.
+ *
+ * Blank node IDs generated for [] and collections are unique but are
+ * not numbered in document order.  Parsing is serial if the world has
+ * a blank node ID handler since it may not expect to be called from
+ * several threads.
+ */
+
+/* Size of input statements in a segment before it is handed to a worker */
+#define RAPTOR_TURTLE_SEGMENT_SIZE (256 * 1024)
+
+/* Segments that may be outstanding per worker thread */
+#define RAPTOR_TURTLE_SEGMENTS_PER_THREAD 2
+
+/* Spaces parsed after a directive so the lexer returns its final '.'
+ * now rather than waiting for more input
+ */
+#define RAPTOR_TURTLE_SPLIT_PADDING "                "
+
+typedef enum {
+  RAPTOR_TURTLE_SPLIT_MORE,      /* statement continues in the next chunk */
+  RAPTOR_TURTLE_SPLIT_TRIPLES,   /* triples statement */
+  RAPTOR_TURTLE_SPLIT_DIRECTIVE, /* @prefix, @base, PREFIX or BASE */
+  RAPTOR_TURTLE_SPLIT_SPACE,     /* only white space and comments left */
+  RAPTOR_TURTLE_SPLIT_UNSAFE     /* cannot be split; parse serially */
+} raptor_turtle_split_status;
+
+typedef enum {
+  RAPTOR_TURTLE_SPLIT_STATE_SPACE,         /* before the statement */
+  RAPTOR_TURTLE_SPLIT_STATE_SPACE_COMMENT, /* comment before the statement */
+  RAPTOR_TURTLE_SPLIT_STATE_BODY,
+  RAPTOR_TURTLE_SPLIT_STATE_COMMENT,
+  RAPTOR_TURTLE_SPLIT_STATE_IRI,
+  RAPTOR_TURTLE_SPLIT_STATE_STRING,
+  RAPTOR_TURTLE_SPLIT_STATE_LONG_STRING
+} raptor_turtle_split_state;
+
+typedef struct raptor_turtle_segment_s raptor_turtle_segment;
+
+struct raptor_turtle_segment_s {
+  raptor_turtle_segment* next;
+
+  raptor_world* world;
+  raptor_uri* base_uri;
+
+  /* directives to parse first; only appended to by the parser thread
+   * when no segments are outstanding */
+  const unsigned char* prologue;
+  size_t prologue_length;
+
+  unsigned char* input;
+  size_t input_length;
+  size_t input_size;
+  /* line number at the start of input */
+  int lineno;
+
+  /* statements returned by the parse */
+  raptor_statement* statements;
+  int statements_count;
+  int statements_size;
+
+  /* namespaces declared while parsing */
+  int namespaces;
+  /* non-0 if a statement could not be stored */
+  int oom;
+  /* non-0 if the input must be parsed serially */
+  int failed;
+};
+
+struct raptor_turtle_split_s {
+  raptor_workers* workers;
+
+  /* non-0 after switching to serial parsing for the rest of the input */
+  int serial;
+  /* non-0 to parse the next statement on the parser thread */
+  int serial_next;
+
+  /* base URI at the start of the parse */
+  raptor_uri* base_uri;
+
+  /* input not yet handed on; the next statement starts at offset */
+  unsigned char* buffer;
+  size_t offset;
+  size_t length;
+  size_t size;
+  /* line number at offset */
+  int lineno;
+
+  /* scan of the statement at offset: bytes from offset and state */
+  size_t scan;
+  raptor_turtle_split_state state;
+  raptor_turtle_split_status kind;
+  /* non-0 for a PREFIX or BASE directive which ends after its IRI */
+  int sparql;
+  /* offset of the directive keyword from the statement start */
+  size_t keyword;
+  int depth;
+  /* string quote character */
+  int quote;
+
+  /* bytes that end a run of statement body */
+  unsigned char body_delims[256];
+  raptor_scan_set iri_delims;
+  raptor_scan_set comment_delims;
+  /* string delimiters for '"' and '\'' quotes */
+  raptor_scan_set string_delims[2];
+  raptor_scan_set long_string_delims[2];
+
+  /* directives seen so far, each followed by a newline */
+  unsigned char* prologue;
+  size_t prologue_length;
+  size_t prologue_size;
+
+  /* segment being filled */
+  raptor_turtle_segment* segment;
+  /* failed segment and the segments after it, in document order */
+  raptor_turtle_segment* replay;
+  raptor_turtle_segment* replay_tail;
+  /* segments kept for reuse */
+  raptor_turtle_segment* free_segments;
+};
+
+
+static void
+raptor_turtle_segment_clear_statements(raptor_turtle_segment* segment)
+{
+  int i;
+
+  for(i = 0; i < segment->statements_count; i++)
+    raptor_statement_clear(&segment->statements[i]);
+  segment->statements_count = 0;
+}
+
+
+static void
+raptor_free_turtle_segment(raptor_turtle_segment* segment)
+{
+  raptor_turtle_segment_clear_statements(segment);
+
+  if(segment->statements)
+    RAPTOR_FREE(raptor_statement*, segment->statements);
+  if(segment->input)
+    RAPTOR_FREE(char*, segment->input);
+  RAPTOR_FREE(raptor_turtle_segment, segment);
+}
+
+
+static void
+raptor_turtle_segment_statement_handler(void* user_data,
+                                        raptor_statement* statement)
+{
+  raptor_turtle_segment* segment = (raptor_turtle_segment*)user_data;
+  raptor_statement* copy;
+
+  if(segment->statements_count == segment->statements_size) {
+    int new_size = segment->statements_size ? segment->statements_size * 2 : 1024;
+    raptor_statement* statements;
+
+    statements = RAPTOR_REALLOC(raptor_statement*, segment->statements,
+                                RAPTOR_GOOD_CAST(size_t, new_size) * sizeof(*statements));
+    if(!statements) {
+      segment->oom = 1;
+      return;
+    }
+    segment->statements = statements;
+    segment->statements_size = new_size;
+  }
+
+  copy = &segment->statements[segment->statements_count++];
+  raptor_statement_init(copy, segment->world);
+  copy->subject = raptor_term_copy(statement->subject);
+  copy->predicate = raptor_term_copy(statement->predicate);
+  copy->object = raptor_term_copy(statement->object);
+  copy->graph = raptor_term_copy(statement->graph);
+}
+
+
+static void
+raptor_turtle_segment_namespace_handler(void* user_data,
+                                        raptor_namespace* nspace)
+{
+  raptor_turtle_segment* segment = (raptor_turtle_segment*)user_data;
+
+  segment->namespaces++;
+}
+
+
+/*
+ * raptor_turtle_parse_segment:
+ * @data: segment
+ *
+ * INTERNAL - Parse a segment on a worker thread
+ *
+ * The segment fails if the parse logs any message or declares a
+ * prefix or base URI that the parser thread would not know about.
+ */
+static void
+raptor_turtle_parse_segment(void* data)
+{
+  raptor_turtle_segment* segment = (raptor_turtle_segment*)data;
+  raptor_parser* parser = NULL;
+  raptor_uri* base_uri = NULL;
+  int messages = 0;
+  int namespaces;
+
+  segment->failed = 1;
+  segment->namespaces = 0;
+  segment->oom = 0;
+
+  if(raptor_log_set_thread_message_count(&messages))
+    return;
+
+  parser = raptor_new_parser(segment->world, "turtle");
+  if(!parser)
+    goto tidy;
+
+  /* the parser thread returns the graph marks */
+  parser->emit_graph_marks = 0;
+  raptor_parser_set_statement_handler(parser, segment,
+                                      raptor_turtle_segment_statement_handler);
+  raptor_parser_set_namespace_handler(parser, segment,
+                                      raptor_turtle_segment_namespace_handler);
+
+  if(raptor_parser_parse_start(parser, segment->base_uri))
+    goto tidy;
+
+  if(segment->prologue_length &&
+     raptor_parser_parse_chunk(parser, segment->prologue,
+                               segment->prologue_length, 0))
+    goto tidy;
+
+  namespaces = segment->namespaces;
+  base_uri = raptor_uri_copy(parser->base_uri);
+
+  if(raptor_parser_parse_chunk(parser, segment->input,
+                               segment->input_length, 1))
+    goto tidy;
+
+  if(!messages && !segment->oom && segment->namespaces == namespaces &&
+     raptor_uri_equals(base_uri, parser->base_uri))
+    segment->failed = 0;
+
+  tidy:
+  if(base_uri)
+    raptor_free_uri(base_uri);
+  if(parser)
+    raptor_free_parser(parser);
+
+  raptor_log_set_thread_message_count(NULL);
+}
+
+
+/*
+ * raptor_turtle_emit_segment:
+ * @rdf_parser: parser
+ * @segment: parsed segment
+ *
+ * INTERNAL - Return the statements of a parsed segment
+ */
+static void
+raptor_turtle_emit_segment(raptor_parser* rdf_parser,
+                           raptor_turtle_segment* segment)
+{
+  int i;
+
+  if(segment->statements_count && !rdf_parser->emitted_default_graph) {
+    /* start default graph at first triple as in serial parsing */
+    raptor_parser_start_graph(rdf_parser, NULL, 0);
+    rdf_parser->emitted_default_graph++;
+  }
+
+  if(RAPTOR_PARSER_HAS_STATEMENT_HANDLER(rdf_parser)) {
+    for(i = 0; i < segment->statements_count; i++)
+      raptor_parser_emit_statement(rdf_parser, &segment->statements[i]);
+  }
+
+  raptor_turtle_segment_clear_statements(segment);
+}
+
+
+static void
+raptor_turtle_split_keep_segment(raptor_turtle_split* split,
+                                 raptor_turtle_segment* segment)
+{
+  raptor_turtle_segment_clear_statements(segment);
+  segment->next = split->free_segments;
+  split->free_segments = segment;
+}
+
+
+/*
+ * raptor_turtle_collect_segments:
+ * @rdf_parser: parser
+ * @max_pending: collect until no more than this many segments are pending
+ * @wait: non-0 to block until segments are done
+ *
+ * INTERNAL - Collect parsed segments from the workers and emit them
+ *
+ * After a failed segment, it and all later segments are collected
+ * onto the replay list to be parsed serially.
+ */
+static void
+raptor_turtle_collect_segments(raptor_parser* rdf_parser, int max_pending,
+                               int wait)
+{
+  raptor_turtle_parser* turtle_parser = (raptor_turtle_parser*)rdf_parser->context;
+  raptor_turtle_split* split = turtle_parser->split;
+
+  while(raptor_workers_get_pending(split->workers) > max_pending) {
+    raptor_turtle_segment* segment;
+
+    segment = (raptor_turtle_segment*)raptor_workers_next_done(split->workers,
+                                                               1, wait);
+    if(!segment)
+      break;
+
+    if(segment->failed || split->replay) {
+      raptor_turtle_segment_clear_statements(segment);
+      segment->next = NULL;
+      if(split->replay_tail)
+        split->replay_tail->next = segment;
+      else
+        split->replay = segment;
+      split->replay_tail = segment;
+
+      /* everything after a failure is parsed serially */
+      max_pending = 0;
+      wait = 1;
+      continue;
+    }
+
+    raptor_turtle_emit_segment(rdf_parser, segment);
+    raptor_turtle_split_keep_segment(split, segment);
+  }
+}
+
+
+/*
+ * raptor_turtle_submit_segment:
+ * @rdf_parser: parser
+ * @drain: non-0 to wait for all segments to be collected
+ *
+ * INTERNAL - Hand the current segment to a worker
+ *
+ * Return value: non-0 on failure
+ */
+static int
+raptor_turtle_submit_segment(raptor_parser* rdf_parser, int drain)
+{
+  raptor_turtle_parser* turtle_parser = (raptor_turtle_parser*)rdf_parser->context;
+  raptor_turtle_split* split = turtle_parser->split;
+  raptor_turtle_segment* segment = split->segment;
+  int max_pending;
+
+  if(segment) {
+    split->segment = NULL;
+
+    segment->prologue = split->prologue;
+    segment->prologue_length = split->prologue_length;
+
+    if(raptor_workers_submit(split->workers, raptor_turtle_parse_segment,
+                             segment)) {
+      raptor_free_turtle_segment(segment);
+      return 1;
+    }
+  }
+
+  if(drain) {
+    raptor_turtle_collect_segments(rdf_parser, 0, 1);
+    return 0;
+  }
+
+  /* bound the memory used by segments waiting to be emitted */
+  max_pending = raptor_workers_get_count(split->workers) *
+                RAPTOR_TURTLE_SEGMENTS_PER_THREAD;
+  raptor_turtle_collect_segments(rdf_parser, max_pending, 1);
+
+  /* and emit anything else that is ready now */
+  raptor_turtle_collect_segments(rdf_parser, 0, 0);
+
+  return 0;
+}
+
+
+/*
+ * raptor_turtle_segment_add_statement:
+ * @rdf_parser: parser
+ * @statement: statement text
+ * @len: length of statement
+ *
+ * INTERNAL - Add a triples statement to the current segment, submitting it when full
+ *
+ * Return value: non-0 on failure
+ */
+static int
+raptor_turtle_segment_add_statement(raptor_parser* rdf_parser,
+                                    const unsigned char* statement,
+                                    size_t len)
+{
+  raptor_turtle_parser* turtle_parser = (raptor_turtle_parser*)rdf_parser->context;
+  raptor_turtle_split* split = turtle_parser->split;
+  raptor_turtle_segment* segment = split->segment;
+
+  if(!segment) {
+    segment = split->free_segments;
+    if(segment)
+      split->free_segments = segment->next;
+    else {
+      segment = RAPTOR_CALLOC(raptor_turtle_segment*, 1, sizeof(*segment));
+      if(!segment)
+        return 1;
+    }
+    segment->next = NULL;
+    segment->world = rdf_parser->world;
+    segment->base_uri = split->base_uri;
+    segment->input_length = 0;
+    segment->lineno = split->lineno;
+    segment->failed = 0;
+    split->segment = segment;
+  }
+
+  if(RAPTOR_SIZE_T_ADD_OVERFLOWS(segment->input_length, len))
+    return 1;
+  if(segment->input_length + len > segment->input_size) {
+    size_t new_size = segment->input_size ? segment->input_size : RAPTOR_TURTLE_SEGMENT_SIZE;
+    unsigned char* input;
+
+    while(new_size < segment->input_length + len) {
+      if(RAPTOR_SIZE_T_ADD_OVERFLOWS(new_size, new_size))
+        return 1;
+      new_size += new_size;
+    }
+    input = RAPTOR_REALLOC(unsigned char*, segment->input, new_size);
+    if(!input)
+      return 1;
+    segment->input = input;
+    segment->input_size = new_size;
+  }
+
+  memcpy(segment->input + segment->input_length, statement, len);
+  segment->input_length += len;
+
+  if(segment->input_length >= RAPTOR_TURTLE_SEGMENT_SIZE)
+    return raptor_turtle_submit_segment(rdf_parser, 0);
+
+  return 0;
+}
+
+
+/* Count the lines ended in [@p, @end) by \n, \r\n or \r */
+static int
+raptor_turtle_count_lines(const unsigned char* p, const unsigned char* end)
+{
+  int lines = 0;
+
+  for(; p < end; p++) {
+    if(*p == '\n' || (*p == '\r' && (p + 1 == end || p[1] != '\n')))
+      lines++;
+  }
+
+  return lines;
+}
+
+
+#define RAPTOR_TURTLE_SPLIT_IS_SPACE(c) \
+  ((c) == ' ' || (c) == '\t' || (c) == '\r' || (c) == '\n')
+
+/*
+ * raptor_turtle_split_statement:
+ * @split: split state
+ * @is_end: non-0 if there is no more input
+ * @len_p: pointer to store the statement length
+ *
+ * INTERNAL - Find the end of the statement at the split offset
+ *
+ * The statement includes the white space and comments before it.
+ * The scan resumes where it stopped when more input is appended.
+ *
+ * Return value: statement kind or whether more input is needed
+ */
+static raptor_turtle_split_status
+raptor_turtle_split_statement(raptor_turtle_split* split, int is_end,
+                              size_t* len_p)
+{
+  const unsigned char* start = split->buffer + split->offset;
+  const unsigned char* end = split->buffer + split->length;
+  const unsigned char* p = start + split->scan;
+  int q;
+
+  while(p < end) {
+    int c = *p;
+
+    switch(split->state) {
+      case RAPTOR_TURTLE_SPLIT_STATE_SPACE:
+        if(RAPTOR_TURTLE_SPLIT_IS_SPACE(c)) {
+          p++;
+          break;
+        }
+        if(c == '#') {
+          split->state = RAPTOR_TURTLE_SPLIT_STATE_SPACE_COMMENT;
+          p++;
+          break;
+        }
+
+        split->kind = RAPTOR_TURTLE_SPLIT_TRIPLES;
+        split->sparql = 0;
+        split->keyword = RAPTOR_GOOD_CAST(size_t, p - start);
+        if(c == '@')
+          split->kind = RAPTOR_TURTLE_SPLIT_DIRECTIVE;
+        else if(c == 'P' || c == 'p' || c == 'B' || c == 'b') {
+          const char* keyword = (c == 'P' || c == 'p') ? "prefix" : "base";
+          size_t keyword_len = strlen(keyword);
+
+          if(RAPTOR_GOOD_CAST(size_t, end - p) <= keyword_len) {
+            if(!is_end)
+              goto more;
+          } else if(!raptor_strncasecmp((const char*)p, keyword, keyword_len) &&
+                    RAPTOR_TURTLE_SPLIT_IS_SPACE(p[keyword_len])) {
+            split->kind = RAPTOR_TURTLE_SPLIT_DIRECTIVE;
+            split->sparql = 1;
+          }
+        }
+        split->state = RAPTOR_TURTLE_SPLIT_STATE_BODY;
+        split->depth = 0;
+        break;
+
+      case RAPTOR_TURTLE_SPLIT_STATE_SPACE_COMMENT:
+      case RAPTOR_TURTLE_SPLIT_STATE_COMMENT:
+        p = raptor_scan_set_find(&split->comment_delims, p, end);
+        if(p == end)
+          break;
+        split->state = (split->state == RAPTOR_TURTLE_SPLIT_STATE_COMMENT) ?
+          RAPTOR_TURTLE_SPLIT_STATE_BODY : RAPTOR_TURTLE_SPLIT_STATE_SPACE;
+        break;
+
+      case RAPTOR_TURTLE_SPLIT_STATE_IRI:
+        p = raptor_scan_set_find(&split->iri_delims, p, end);
+        if(p == end)
+          break;
+        p++;
+        if(split->sparql) {
+          /* PREFIX and BASE end after their IRI */
+          *len_p = RAPTOR_GOOD_CAST(size_t, p - start);
+          return split->kind;
+        }
+        split->state = RAPTOR_TURTLE_SPLIT_STATE_BODY;
+        break;
+
+      case RAPTOR_TURTLE_SPLIT_STATE_STRING:
+      case RAPTOR_TURTLE_SPLIT_STATE_LONG_STRING:
+        q = (split->quote == '"') ? 0 : 1;
+        if(split->state == RAPTOR_TURTLE_SPLIT_STATE_STRING)
+          p = raptor_scan_set_find(&split->string_delims[q], p, end);
+        else
+          p = raptor_scan_set_find(&split->long_string_delims[q], p, end);
+        if(p == end)
+          break;
+
+        c = *p;
+        if(c == '\\') {
+          if(p + 1 == end)
+            goto more_or_unsafe;
+          p += 2;
+        } else if(c == '\r' || c == '\n') {
+          /* only allowed in long strings */
+          goto unsafe;
+        } else if(split->state == RAPTOR_TURTLE_SPLIT_STATE_STRING) {
+          p++;
+          split->state = RAPTOR_TURTLE_SPLIT_STATE_BODY;
+        } else if(end - p < 3) {
+          goto more_or_unsafe;
+        } else if(p[1] == c && p[2] == c) {
+          p += 3;
+          split->state = RAPTOR_TURTLE_SPLIT_STATE_BODY;
+        } else
+          p++;
+        break;
+
+      case RAPTOR_TURTLE_SPLIT_STATE_BODY:
+      default:
+        while(p < end && !split->body_delims[*p])
+          p++;
+        if(p == end)
+          break;
+
+        c = *p;
+        if(c == '<') {
+          split->state = RAPTOR_TURTLE_SPLIT_STATE_IRI;
+          p++;
+        } else if(c == '"' || c == '\'') {
+          if(end - p < 3)
+            goto more_or_unsafe;
+          split->quote = c;
+          if(p[1] == c && p[2] == c) {
+            split->state = RAPTOR_TURTLE_SPLIT_STATE_LONG_STRING;
+            p += 3;
+          } else {
+            split->state = RAPTOR_TURTLE_SPLIT_STATE_STRING;
+            p++;
+          }
+        } else if(c == '#') {
+          split->state = RAPTOR_TURTLE_SPLIT_STATE_COMMENT;
+          p++;
+        } else if(c == '\\') {
+          if(p + 1 == end)
+            goto more_or_unsafe;
+          p += 2;
+        } else if(c == '[' || c == '(') {
+          split->depth++;
+          p++;
+        } else if(c == ']' || c == ')') {
+          if(!split->depth--)
+            goto unsafe;
+          p++;
+        } else if(c == '.') {
+          p++;
+          if(split->depth || split->sparql)
+            break;
+          if(p == end) {
+            if(!is_end) {
+              p--;
+              goto more;
+            }
+          } else if(!RAPTOR_TURTLE_SPLIT_IS_SPACE(*p) && *p != '#')
+            break;
+
+          *len_p = RAPTOR_GOOD_CAST(size_t, p - start);
+          return split->kind;
+        } else
+          /* '{' or '}' */
+          goto unsafe;
+        break;
+    }
+  }
+
+  if(!is_end)
+    goto more;
+
+  if(split->state == RAPTOR_TURTLE_SPLIT_STATE_SPACE ||
+     split->state == RAPTOR_TURTLE_SPLIT_STATE_SPACE_COMMENT)
+    return RAPTOR_TURTLE_SPLIT_SPACE;
+
+  /* statement not ended */
+  goto unsafe;
+
+  more_or_unsafe:
+  if(is_end)
+    goto unsafe;
+
+  more:
+  split->scan = RAPTOR_GOOD_CAST(size_t, p - start);
+  return RAPTOR_TURTLE_SPLIT_MORE;
+
+  unsafe:
+  return RAPTOR_TURTLE_SPLIT_UNSAFE;
+}
+
+
+/*
+ * raptor_turtle_split_consume:
+ * @split: split state
+ * @len: length of statement at the offset
+ *
+ * INTERNAL - Move the split offset past a statement
+ */
+static void
+raptor_turtle_split_consume(raptor_turtle_split* split, size_t len)
+{
+  const unsigned char* start = split->buffer + split->offset;
+
+  split->lineno += raptor_turtle_count_lines(start, start + len);
+  split->offset += len;
+
+  split->scan = 0;
+  split->state = RAPTOR_TURTLE_SPLIT_STATE_SPACE;
+  split->depth = 0;
+  split->sparql = 0;
+}
+
+
+/*
+ * raptor_turtle_split_fallback:
+ * @rdf_parser: parser
+ *
+ * INTERNAL - Parse the replay segments and the rest of the input serially
+ *
+ * Called with no segments outstanding.  Later chunks are parsed
+ * serially too.
+ *
+ * Return value: non-0 on failure
+ */
+static int
+raptor_turtle_split_fallback(raptor_parser* rdf_parser)
+{
+  raptor_turtle_parser* turtle_parser = (raptor_turtle_parser*)rdf_parser->context;
+  raptor_turtle_split* split = turtle_parser->split;
+  raptor_turtle_segment* segment;
+  int rc = 0;
+
+  split->serial = 1;
+
+  turtle_parser->lineno = split->replay ? split->replay->lineno : split->lineno;
+
+  while((segment = split->replay)) {
+    split->replay = segment->next;
+
+    if(!rc)
+      rc = raptor_turtle_parse_serial_chunk(rdf_parser, segment->input,
+                                            segment->input_length, 0);
+    raptor_turtle_split_keep_segment(split, segment);
+  }
+  split->replay_tail = NULL;
+
+  if(!rc)
+    rc = raptor_turtle_parse_serial_chunk(rdf_parser,
+                                          split->buffer + split->offset,
+                                          split->length - split->offset, 0);
+  split->offset = split->length;
+
+  return rc;
+}
+
+
+/*
+ * raptor_turtle_split_parse_statement:
+ * @rdf_parser: parser
+ * @statement: statement text
+ * @len: length of statement
+ *
+ * INTERNAL - Parse a statement on the parser thread
+ *
+ * Return value: non-0 on failure
+ */
+static int
+raptor_turtle_split_parse_statement(raptor_parser* rdf_parser,
+                                    const unsigned char* statement,
+                                    size_t len)
+{
+  raptor_turtle_parser* turtle_parser = (raptor_turtle_parser*)rdf_parser->context;
+  int rc;
+
+  turtle_parser->lineno = turtle_parser->split->lineno;
+  rc = raptor_turtle_parse_serial_chunk(rdf_parser, statement, len, 0);
+  if(!rc)
+    rc = raptor_turtle_parse_serial_chunk(rdf_parser,
+                          (const unsigned char*)RAPTOR_TURTLE_SPLIT_PADDING,
+                          strlen(RAPTOR_TURTLE_SPLIT_PADDING), 0);
+
+  return rc;
+}
+
+
+/*
+ * raptor_turtle_split_add_directive:
+ * @split: split state
+ * @directive: directive text
+ * @len: length of directive
+ *
+ * INTERNAL - Add a directive to the prologue
+ *
+ * PREFIX and BASE are added in the @prefix and @base forms which end
+ * with a '.' so workers read them before the segment input.
+ *
+ * Return value: non-0 on failure
+ */
+static int
+raptor_turtle_split_add_directive(raptor_turtle_split* split,
+                                  const unsigned char* directive, size_t len)
+{
+  size_t padding_len = strlen(RAPTOR_TURTLE_SPLIT_PADDING);
+  const char* keyword = NULL;
+  size_t skip = 0;
+  size_t needed;
+
+  if(split->sparql) {
+    int is_prefix = (directive[split->keyword] == 'P' ||
+                     directive[split->keyword] == 'p');
+
+    keyword = is_prefix ? "@prefix" : "@base";
+    skip = is_prefix ? 6 : 4;
+  }
+
+  /* directive, " .", newline and padding */
+  needed = len + 3 + padding_len + (keyword ? strlen(keyword) : 0);
+  if(RAPTOR_SIZE_T_ADD_OVERFLOWS(split->prologue_length, needed))
+    return 1;
+  if(split->prologue_length + needed > split->prologue_size) {
+    size_t new_size = split->prologue_size ? split->prologue_size : 1024;
+    unsigned char* prologue;
+
+    while(new_size < split->prologue_length + needed) {
+      if(RAPTOR_SIZE_T_ADD_OVERFLOWS(new_size, new_size))
+        return 1;
+      new_size += new_size;
+    }
+    prologue = RAPTOR_REALLOC(unsigned char*, split->prologue, new_size);
+    if(!prologue)
+      return 1;
+    split->prologue = prologue;
+    split->prologue_size = new_size;
+  }
+
+  if(split->prologue_length)
+    /* replace the padding after the previous directive */
+    split->prologue_length -= padding_len;
+
+  if(keyword) {
+    size_t keyword_len = strlen(keyword);
+
+    memcpy(split->prologue + split->prologue_length, directive,
+           split->keyword);
+    split->prologue_length += split->keyword;
+    memcpy(split->prologue + split->prologue_length, keyword, keyword_len);
+    split->prologue_length += keyword_len;
+    directive += split->keyword + skip;
+    len -= split->keyword + skip;
+  }
+
+  memcpy(split->prologue + split->prologue_length, directive, len);
+  split->prologue_length += len;
+  if(keyword) {
+    split->prologue[split->prologue_length++] = ' ';
+    split->prologue[split->prologue_length++] = '.';
+  }
+  split->prologue[split->prologue_length++] = '\n';
+  memcpy(split->prologue + split->prologue_length,
+         RAPTOR_TURTLE_SPLIT_PADDING, padding_len);
+  split->prologue_length += padding_len;
+
+  return 0;
+}
+
+
+/*
+ * raptor_turtle_split_append:
+ * @split: split state
+ * @s: input
+ * @len: length of input
+ *
+ * INTERNAL - Append input to the split window
+ *
+ * Return value: non-0 on failure
+ */
+static int
+raptor_turtle_split_append(raptor_turtle_split* split,
+                           const unsigned char* s, size_t len)
+{
+  if(split->offset) {
+    /* drop the statements already handed on */
+    memmove(split->buffer, split->buffer + split->offset,
+            split->length - split->offset);
+    split->length -= split->offset;
+    split->offset = 0;
+  }
+
+  if(RAPTOR_SIZE_T_ADD_OVERFLOWS(split->length, len))
+    return 1;
+  if(split->length + len > split->size) {
+    size_t new_size = split->size ? split->size : 4096;
+    unsigned char* buffer;
+
+    while(new_size < split->length + len) {
+      if(RAPTOR_SIZE_T_ADD_OVERFLOWS(new_size, new_size))
+        return 1;
+      new_size += new_size;
+    }
+    buffer = RAPTOR_REALLOC(unsigned char*, split->buffer, new_size);
+    if(!buffer)
+      return 1;
+    split->buffer = buffer;
+    split->size = new_size;
+  }
+
+  memcpy(split->buffer + split->length, s, len);
+  split->length += len;
+
+  return 0;
+}
+
+
+/*
+ * raptor_turtle_parse_split_chunk:
+ * @rdf_parser: parser
+ * @s: input
+ * @len: length of input
+ * @is_end: non-0 if this is the final chunk
+ *
+ * INTERNAL - Parse a chunk by splitting it into statements for the workers
+ *
+ * Return value: non-0 on failure
+ */
+static int
+raptor_turtle_parse_split_chunk(raptor_parser* rdf_parser,
+                                const unsigned char* s, size_t len,
+                                int is_end)
+{
+  raptor_turtle_parser* turtle_parser = (raptor_turtle_parser*)rdf_parser->context;
+  raptor_turtle_split* split = turtle_parser->split;
+  int rc = 0;
+
+  if(len && raptor_turtle_split_append(split, s, len))
+    return 1;
+
+  while(!rc) {
+    raptor_turtle_split_status status;
+    size_t statement_len = 0;
+
+    status = raptor_turtle_split_statement(split, is_end, &statement_len);
+
+    if(status == RAPTOR_TURTLE_SPLIT_MORE)
+      break;
+
+    if(status == RAPTOR_TURTLE_SPLIT_SPACE) {
+      raptor_turtle_split_consume(split, split->length - split->offset);
+      break;
+    }
+
+    if(status == RAPTOR_TURTLE_SPLIT_TRIPLES && !split->serial_next) {
+      rc = raptor_turtle_segment_add_statement(rdf_parser,
+                                               split->buffer + split->offset,
+                                               statement_len);
+      raptor_turtle_split_consume(split, statement_len);
+      if(!rc && split->replay)
+        return raptor_turtle_split_fallback(rdf_parser) ||
+               raptor_turtle_parse_serial_chunk(rdf_parser, NULL, 0, is_end);
+      continue;
+    }
+
+    /* anything else is parsed here after all earlier statements */
+    if(raptor_turtle_submit_segment(rdf_parser, 1))
+      return 1;
+
+    if(status == RAPTOR_TURTLE_SPLIT_UNSAFE || split->replay)
+      return raptor_turtle_split_fallback(rdf_parser) ||
+             raptor_turtle_parse_serial_chunk(rdf_parser, NULL, 0, is_end);
+
+    rc = raptor_turtle_split_parse_statement(rdf_parser,
+                                             split->buffer + split->offset,
+                                             statement_len);
+    if(!rc && status == RAPTOR_TURTLE_SPLIT_DIRECTIVE)
+      rc = raptor_turtle_split_add_directive(split,
+                                             split->buffer + split->offset,
+                                             statement_len);
+    split->serial_next = split->sparql;
+    raptor_turtle_split_consume(split, statement_len);
+  }
+
+  if(rc || !is_end)
+    return rc;
+
+  if(raptor_turtle_submit_segment(rdf_parser, 1))
+    return 1;
+  if(split->replay && raptor_turtle_split_fallback(rdf_parser))
+    return 1;
+
+  turtle_parser->lineno = split->lineno;
+  return raptor_turtle_parse_serial_chunk(rdf_parser, NULL, 0, 1);
+}
+
+
+/*
+ * raptor_turtle_discard_segments:
+ * @split: split state
+ *
+ * INTERNAL - Wait for and discard any segments from an unfinished parse
+ */
+static void
+raptor_turtle_discard_segments(raptor_turtle_split* split)
+{
+  raptor_turtle_segment* segment;
+
+  while((segment = (raptor_turtle_segment*)raptor_workers_next_done(split->workers, 0, 1)))
+    raptor_turtle_split_keep_segment(split, segment);
+
+  while((segment = split->replay)) {
+    split->replay = segment->next;
+    raptor_turtle_split_keep_segment(split, segment);
+  }
+  split->replay_tail = NULL;
+
+  if(split->segment) {
+    raptor_turtle_split_keep_segment(split, split->segment);
+    split->segment = NULL;
+  }
+}
+
+
+static void
+raptor_free_turtle_split(raptor_turtle_split* split)
+{
+  raptor_turtle_segment* segment;
+
+  raptor_turtle_discard_segments(split);
+  raptor_free_workers(split->workers);
+
+  while((segment = split->free_segments)) {
+    split->free_segments = segment->next;
+    raptor_free_turtle_segment(segment);
+  }
+
+  if(split->base_uri)
+    raptor_free_uri(split->base_uri);
+  if(split->buffer)
+    RAPTOR_FREE(char*, split->buffer);
+  if(split->prologue)
+    RAPTOR_FREE(char*, split->prologue);
+  RAPTOR_FREE(raptor_turtle_split, split);
+}
+
+
+/*
+ * raptor_new_turtle_split:
+ * @threads: number of worker threads
+ *
+ * INTERNAL - Create parallel parsing state
+ *
+ * Return value: new split state or NULL on failure or without thread support
+ */
+static raptor_turtle_split*
+raptor_new_turtle_split(int threads)
+{
+  raptor_turtle_split* split;
+  const char* delims;
+  int q;
+
+  split = RAPTOR_CALLOC(raptor_turtle_split*, 1, sizeof(*split));
+  if(!split)
+    return NULL;
+
+  split->workers = raptor_new_workers(threads);
+  if(!split->workers) {
+    RAPTOR_FREE(raptor_turtle_split, split);
+    return NULL;
+  }
+
+  for(delims = "<\"'#\\[]().{}"; *delims; delims++)
+    split->body_delims[(unsigned char)*delims] = 1;
+
+  raptor_scan_set_init(&split->iri_delims, (const unsigned char*)">", 1);
+  raptor_scan_set_init(&split->comment_delims, (const unsigned char*)"\r\n", 2);
+  for(q = 0; q < 2; q++) {
+    const unsigned char* quote = (const unsigned char*)(q ? "'" : "\"");
+    unsigned char bytes[4];
+
+    bytes[0] = *quote;
+    bytes[1] = '\\';
+    bytes[2] = '\r';
+    bytes[3] = '\n';
+    raptor_scan_set_init(&split->string_delims[q], bytes, 4);
+    raptor_scan_set_init(&split->long_string_delims[q], bytes, 2);
+  }
+
+  return split;
+}
+
+
+/*
+ * raptor_turtle_split_start:
+ * @rdf_parser: parser
+ *
+ * INTERNAL - Reset the parallel parsing state for a new parse
+ *
+ * Return value: non-0 on failure
+ */
+static int
+raptor_turtle_split_start(raptor_parser* rdf_parser)
+{
+  raptor_turtle_parser* turtle_parser = (raptor_turtle_parser*)rdf_parser->context;
+  raptor_turtle_split* split = turtle_parser->split;
+
+  /* drop any segments left from an unfinished parse */
+  raptor_turtle_discard_segments(split);
+
+  if(split->base_uri)
+    raptor_free_uri(split->base_uri);
+  split->base_uri = raptor_uri_copy(rdf_parser->base_uri);
+
+  split->serial = 0;
+  split->serial_next = 0;
+  split->offset = 0;
+  split->length = 0;
+  split->lineno = 1;
+  split->scan = 0;
+  split->state = RAPTOR_TURTLE_SPLIT_STATE_SPACE;
+  split->depth = 0;
+  split->sparql = 0;
+  split->prologue_length = 0;
+
+  return 0;
+}
+
+
+/**
+ * raptor_turtle_parse_chunk - Parse a chunk of Turtle/TriG
+ * @rdf_parser: Raptor parser
+ * @s: Input buffer
+ * @len: Length of input
+ * @is_end: Non-zero if this is the final chunk
+ *
+ * Return value: 0 on success, non-0 on failure
+ */
+static int
+raptor_turtle_parse_chunk(raptor_parser *rdf_parser, 
+                          const unsigned char *s, size_t len,
+                          int is_end)
+{
+  raptor_turtle_parser *turtle_parser = (raptor_turtle_parser*)rdf_parser->context;
+
+  if(turtle_parser->split && !turtle_parser->split->serial)
+    return raptor_turtle_parse_split_chunk(rdf_parser, s, len, is_end);
+
+  return raptor_turtle_parse_serial_chunk(rdf_parser, s, len, is_end);
+}
+
+
 /**
  * raptor_turtle_parse_start - Initialize Turtle/TriG parser for streaming
  * @rdf_parser: Raptor parser
@@ -1717,6 +2870,7 @@ raptor_turtle_parse_start(raptor_parser *rdf_parser)
 {
   raptor_locator *locator = &rdf_parser->locator;
   raptor_turtle_parser *turtle_parser = (raptor_turtle_parser*)rdf_parser->context;
+  int threads;
 
   /* base URI required for Turtle */
   if(!rdf_parser->base_uri)
@@ -1737,15 +2891,43 @@ raptor_turtle_parse_start(raptor_parser *rdf_parser)
   fsp_set_user_data(turtle_parser->fsp_ctx, rdf_parser);
 
   /* Initialize lexer */
+#ifdef RAPTOR_TURTLE_SCANNER
+  turtle_parser->scanner = turtle_new_scanner(rdf_parser);
+  if(!turtle_parser->scanner) {
+#else
   if(turtle_lexer_lex_init(&turtle_parser->scanner)) {
+#endif
     fsp_destroy(turtle_parser->fsp_ctx);
     turtle_parser->fsp_ctx = NULL;
     return 1;
   }
   turtle_parser->scanner_set = 1;
 
+#ifndef RAPTOR_TURTLE_SCANNER
   /* Set FSP context as lexer extra data for YY_INPUT */
   turtle_lexer_set_extra(turtle_parser->fsp_ctx, turtle_parser->scanner);
+#endif
+
+  /* Parallel parsing: not for TriG where graphs span statements */
+  threads = RAPTOR_OPTIONS_GET_NUMERIC(rdf_parser, RAPTOR_OPTION_PARSE_THREADS);
+  if(threads < 2 || turtle_parser->trig ||
+     rdf_parser->world->generate_bnodeid_handler ||
+     (turtle_parser->split &&
+      raptor_workers_get_count(turtle_parser->split->workers) != threads)) {
+    if(turtle_parser->split) {
+      raptor_free_turtle_split(turtle_parser->split);
+      turtle_parser->split = NULL;
+    }
+  }
+
+  if(threads >= 2 && !turtle_parser->trig &&
+     !rdf_parser->world->generate_bnodeid_handler) {
+    if(!turtle_parser->split)
+      /* NULL without thread support; then parse serially */
+      turtle_parser->split = raptor_new_turtle_split(threads);
+    if(turtle_parser->split && raptor_turtle_split_start(rdf_parser))
+      return 1;
+  }
 
   return 0;
 }
@@ -0,0 +1,1357 @@
+/* -*- Mode: c; c-basic-offset: 2 -*-
+ *
+ * turtle_scanner.c - Raptor Turtle hand-written scanner
+ *
+ * Copyright (C) 2026, David Beckett http://www.dajobe.org/
+ *
+ * This package is Free Software and part of Redland http://librdf.org/
+ *
+ * It is licensed under the following three licenses as alternatives:
+ *   1. GNU Lesser General Public License (LGPL) V2.1 or any newer version
+ *   2. GNU General Public License (GPL) V2 or any newer version
+ *   3. Apache License, V2.0 or any newer version
+ *
+ * You may not use this file except in compliance with at least one of
+ * the above three licenses.
+ *
+ * See LICENSE.html or LICENSE.txt at the top of this package for the
+ * complete terms and further detail along with the license texts for
+ * the licenses in COPYING.LIB, COPYING and LICENSE-2.0.txt respectively.
+ *
+ *
+ * A direct-coded alternative to the flex scanner in turtle_lexer.l
+ * that returns the same tokens to the grammar in turtle_parser.y.
+ * It is used by the parser when configured with
+ * --with-turtle-lexer=scanner (RAPTOR_TURTLE_LEXER=scanner in cmake).
+ *
+ * The scanner keeps its own copy of the input.  A token that may
+ * continue past the end of the input seen so far is left in the
+ * buffer until more input arrives or the end of input is signalled,
+ * so tokens can be split anywhere across chunks.
+ *
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include <raptor_config.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+
+/* Raptor includes */
+#include "raptor2.h"
+#include "raptor_internal.h"
+
+#ifdef FSP_CONFIG
+#include <fsp_config.h>
+#endif
+#include <fsp.h>
+
+#include <turtle_parser.h>
+#include <turtle_common.h>
+
+
+#ifndef STANDALONE
+
+
+/* Character classes from the Turtle 2013 terminals used by the
+ * flex scanner, with bytes \x80-\xff allowed in names
+ */
+#define TURTLE_CLASS_NAME_START 0x01 /* PN_CHARS_BASE [A-Za-z\x80-\xff] */
+#define TURTLE_CLASS_NAME       0x02 /* PN_CHARS: PN_CHARS_BASE _ - [0-9] */
+#define TURTLE_CLASS_DIGIT      0x04 /* [0-9] */
+#define TURTLE_CLASS_HEX        0x08 /* [0-9A-Fa-f] */
+#define TURTLE_CLASS_IRI        0x10 /* allowed unescaped in an IRI */
+#define TURTLE_CLASS_ALPHA      0x20 /* [A-Za-z] */
+#define TURTLE_CLASS_ESCAPE     0x40 /* allowed after \ in a local name */
+#define TURTLE_CLASS_SPACE      0x80 /* [ \t\v] */
+
+static const unsigned char turtle_scanner_class[256] = {
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x80, 0x00, 0x80, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x80, 0x50, 0x00, 0x50, 0x50, 0x50, 0x50, 0x50,
+  0x50, 0x50, 0x50, 0x50, 0x50, 0x52, 0x50, 0x50,
+  0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e,
+  0x1e, 0x1e, 0x10, 0x50, 0x00, 0x50, 0x00, 0x50,
+  0x50, 0x3b, 0x3b, 0x3b, 0x3b, 0x3b, 0x3b, 0x33,
+  0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x33, 0x33, 0x33, 0x10, 0x00, 0x10, 0x00, 0x52,
+  0x00, 0x3b, 0x3b, 0x3b, 0x3b, 0x3b, 0x3b, 0x33,
+  0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x33, 0x33, 0x33, 0x00, 0x00, 0x00, 0x50, 0x10,
+  0x13, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13,
+  0x13, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13,
+  0x13, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13,
+  0x13, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13,
+  0x13, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13,
+  0x13, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13,
+  0x13, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13,
+  0x13, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13,
+  0x13, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13,
+  0x13, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13,
+  0x13, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13,
+  0x13, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13,
+  0x13, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13,
+  0x13, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13,
+  0x13, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13,
+  0x13, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13, 0x13
+};
+
+#define TURTLE_CLASS(c, class) (turtle_scanner_class[c] & (class))
+
+/* first character of a blank node label or local name: PN_CHARS
+ * without '-'
+ */
+#define TURTLE_CLASS_LABEL_START(c) \
+  (TURTLE_CLASS(c, TURTLE_CLASS_NAME) && (c) != '-')
+
+
+/* Results of turtle_scanner_token() as well as tokens */
+
+/* whitespace or a comment was consumed */
+#define TURTLE_SCANNER_SKIP (-2)
+/* the token may continue past the input so far */
+#define TURTLE_SCANNER_MORE (-3)
+
+
+/* Initial size of the input buffer */
+#define TURTLE_SCANNER_BUFFER_SIZE 4096
+
+
+struct turtle_scanner_s {
+  raptor_parser* rdf_parser;
+
+  /* input not yet consumed is from @start to @end in @buffer; there
+   * is always a spare byte after @end */
+  unsigned char* buffer;
+  size_t size;
+  size_t start;
+  size_t end;
+
+  /* non-0 after @prefix or PREFIX until the prefix name */
+  int in_prefix;
+
+  /* offset into an unfinished long literal to carry on scanning from */
+  size_t resume;
+
+  /* for the token being scanned: end of the input, whether more
+   * input can follow it and if a decision needed that input */
+  const unsigned char* limit;
+  int is_end;
+  int more;
+
+  /* delimiters ending runs of string characters: for "" and '' */
+  raptor_scan_set string_delims[2];
+  raptor_scan_set long_string_delims[2];
+  raptor_scan_set eol_delims;
+};
+
+
+/*
+ * turtle_new_scanner:
+ * @rdf_parser: turtle parser
+ *
+ * INTERNAL - Constructor - create a new Turtle scanner
+ *
+ * Return value: new scanner or NULL on failure
+ */
+turtle_scanner*
+turtle_new_scanner(raptor_parser* rdf_parser)
+{
+  turtle_scanner* scanner;
+  int i;
+
+  scanner = RAPTOR_CALLOC(turtle_scanner*, 1, sizeof(*scanner));
+  if(!scanner)
+    return NULL;
+
+  scanner->rdf_parser = rdf_parser;
+
+  for(i = 0; i < 2; i++) {
+    unsigned char delims[4];
+
+    delims[0] = (unsigned char)(i ? '\'' : '"');
+    delims[1] = '\\';
+    delims[2] = '\n';
+    delims[3] = '\r';
+    raptor_scan_set_init(&scanner->string_delims[i], delims, 4);
+    raptor_scan_set_init(&scanner->long_string_delims[i], delims, 2);
+  }
+  raptor_scan_set_init(&scanner->eol_delims,
+                       (const unsigned char*)"\n\r", 2);
+
+  return scanner;
+}
+
+
+/*
+ * turtle_free_scanner:
+ * @scanner: scanner
+ *
+ * INTERNAL - Destructor - free a Turtle scanner
+ */
+void
+turtle_free_scanner(turtle_scanner* scanner)
+{
+  if(!scanner)
+    return;
+
+  if(scanner->buffer)
+    RAPTOR_FREE(char*, scanner->buffer);
+
+  RAPTOR_FREE(turtle_scanner, scanner);
+}
+
+
+/*
+ * turtle_scanner_append:
+ * @scanner: scanner
+ * @buffer: input
+ * @len: length of @buffer
+ *
+ * INTERNAL - Add input to the end of the scanner's buffer
+ *
+ * Return value: non-0 on failure
+ */
+int
+turtle_scanner_append(turtle_scanner* scanner,
+                      const unsigned char *buffer, size_t len)
+{
+  size_t used = scanner->end - scanner->start;
+  size_t need;
+
+  if(!len)
+    return 0;
+
+  /* move the unconsumed input, at most one unfinished token, to the
+   * front */
+  if(scanner->start) {
+    if(used)
+      memmove(scanner->buffer, scanner->buffer + scanner->start, used);
+    scanner->start = 0;
+    scanner->end = used;
+  }
+
+  if(RAPTOR_SIZE_T_ADD_OVERFLOWS(used, len) ||
+     RAPTOR_SIZE_T_ADD_OVERFLOWS(used + len, 1))
+    return 1;
+  need = used + len + 1;
+
+  if(need > scanner->size) {
+    size_t new_size = scanner->size ? scanner->size : TURTLE_SCANNER_BUFFER_SIZE;
+    unsigned char* new_buffer;
+
+    while(new_size < need) {
+      if(RAPTOR_SIZE_T_ADD_OVERFLOWS(new_size, new_size))
+        return 1;
+      new_size <<= 1;
+    }
+
+    new_buffer = RAPTOR_REALLOC(unsigned char*, scanner->buffer, new_size);
+    if(!new_buffer)
+      return 1;
+    scanner->buffer = new_buffer;
+    scanner->size = new_size;
+  }
+
+  memcpy(scanner->buffer + scanner->end, buffer, len);
+  scanner->end += len;
+
+  return 0;
+}
+
+
+/* byte at @p or -1 past the input; notes if more input could follow */
+static int
+turtle_scanner_peek(turtle_scanner* scanner, const unsigned char* p)
+{
+  if(p < scanner->limit)
+    return *p;
+
+  if(!scanner->is_end)
+    scanner->more = 1;
+
+  return -1;
+}
+
+
+/* PLX: "%" HEX HEX or "\" followed by a name escape character */
+static size_t
+turtle_scanner_scan_plx(turtle_scanner* scanner, const unsigned char* p)
+{
+  int c = turtle_scanner_peek(scanner, p);
+  int c1;
+
+  if(c == '%') {
+    c1 = turtle_scanner_peek(scanner, p + 1);
+    if(c1 < 0 || !TURTLE_CLASS(c1, TURTLE_CLASS_HEX))
+      return 0;
+    c1 = turtle_scanner_peek(scanner, p + 2);
+    if(c1 < 0 || !TURTLE_CLASS(c1, TURTLE_CLASS_HEX))
+      return 0;
+    return 3;
+  }
+
+  if(c == '\\') {
+    c1 = turtle_scanner_peek(scanner, p + 1);
+    if(c1 >= 0 && TURTLE_CLASS(c1, TURTLE_CLASS_ESCAPE))
+      return 2;
+  }
+
+  return 0;
+}
+
+
+/* Rest of a name after the first character:
+ * ((PN_CHARS | ".")* PN_CHARS)* adding ":" and PLX for local names.
+ * Trailing '.'s are not part of the name.
+ */
+static size_t
+turtle_scanner_scan_name_rest(turtle_scanner* scanner,
+                              const unsigned char* p, int is_local)
+{
+  const unsigned char* q = p;
+  const unsigned char* last = p;
+
+  while(1) {
+    int c;
+    size_t n;
+
+    while(q < scanner->limit && TURTLE_CLASS(*q, TURTLE_CLASS_NAME))
+      last = ++q;
+
+    c = turtle_scanner_peek(scanner, q);
+    if(c == '.') {
+      q++;
+      continue;
+    }
+    if(is_local) {
+      if(c == ':') {
+        last = ++q;
+        continue;
+      }
+      n = turtle_scanner_scan_plx(scanner, q);
+      if(n) {
+        q += n;
+        last = q;
+        continue;
+      }
+    }
+    break;
+  }
+
+  return RAPTOR_GOOD_CAST(size_t, last - p);
+}
+
+
+/* QNAME: PN_PREFIX? ":" PN_LOCAL? */
+static size_t
+turtle_scanner_scan_qname(turtle_scanner* scanner, const unsigned char* p)
+{
+  const unsigned char* q = p;
+  int c = turtle_scanner_peek(scanner, q);
+  size_t n;
+
+  if(c >= 0 && TURTLE_CLASS(c, TURTLE_CLASS_NAME_START)) {
+    q++;
+    q += turtle_scanner_scan_name_rest(scanner, q, 0);
+    c = turtle_scanner_peek(scanner, q);
+  }
+
+  if(c != ':')
+    return 0;
+  q++;
+
+  c = turtle_scanner_peek(scanner, q);
+  if(c >= 0 && (TURTLE_CLASS_LABEL_START(c) || c == ':'))
+    n = 1;
+  else
+    n = turtle_scanner_scan_plx(scanner, q);
+  if(n) {
+    q += n;
+    q += turtle_scanner_scan_name_rest(scanner, q, 1);
+  }
+
+  return RAPTOR_GOOD_CAST(size_t, q - p);
+}
+
+
+/* EXPONENT: [eE][+-]?[0-9]+ */
+static size_t
+turtle_scanner_scan_exponent(turtle_scanner* scanner, const unsigned char* p)
+{
+  const unsigned char* q = p;
+  const unsigned char* digits;
+  int c = turtle_scanner_peek(scanner, q);
+
+  if(c != 'e' && c != 'E')
+    return 0;
+  q++;
+
+  c = turtle_scanner_peek(scanner, q);
+  if(c == '+' || c == '-')
+    q++;
+
+  digits = q;
+  while((c = turtle_scanner_peek(scanner, q)) >= 0 &&
+        TURTLE_CLASS(c, TURTLE_CLASS_DIGIT))
+    q++;
+
+  return (q > digits) ? RAPTOR_GOOD_CAST(size_t, q - p) : 0;
+}
+
+
+/* INTEGER, DECIMAL or DOUBLE; returns the token or 0 if none */
+static int
+turtle_scanner_scan_number(turtle_scanner* scanner, const unsigned char* p,
+                           size_t* len_p)
+{
+  const unsigned char* q = p;
+  size_t int_digits;
+  size_t n;
+  int token = 0;
+  int c;
+
+  c = turtle_scanner_peek(scanner, q);
+  if(c == '+' || c == '-')
+    q++;
+
+  n = 0;
+  while((c = turtle_scanner_peek(scanner, q + n)) >= 0 &&
+        TURTLE_CLASS(c, TURTLE_CLASS_DIGIT))
+    n++;
+  int_digits = n;
+  q += n;
+
+  if(int_digits) {
+    token = INTEGER_LITERAL;
+    *len_p = RAPTOR_GOOD_CAST(size_t, q - p);
+  }
+
+  if(c == '.') {
+    const unsigned char* r = q + 1;
+
+    n = 0;
+    while((c = turtle_scanner_peek(scanner, r + n)) >= 0 &&
+          TURTLE_CLASS(c, TURTLE_CLASS_DIGIT))
+      n++;
+    r += n;
+
+    if(n) {
+      token = DECIMAL_LITERAL;
+      *len_p = RAPTOR_GOOD_CAST(size_t, r - p);
+    }
+
+    if(int_digits || n) {
+      n = turtle_scanner_scan_exponent(scanner, r);
+      if(n) {
+        token = FLOATING_LITERAL;
+        *len_p = RAPTOR_GOOD_CAST(size_t, r + n - p);
+      }
+    }
+  } else if(int_digits) {
+    n = turtle_scanner_scan_exponent(scanner, q);
+    if(n) {
+      token = FLOATING_LITERAL;
+      *len_p = RAPTOR_GOOD_CAST(size_t, q + n - p);
+    }
+  }
+
+  return token;
+}
+
+
+/* LANGTAG: "@"[A-Za-z]+([-_][A-Za-z0-9]+)* */
+static size_t
+turtle_scanner_scan_langtag(turtle_scanner* scanner, const unsigned char* p)
+{
+  const unsigned char* q = p + 1;
+  int c;
+
+  while((c = turtle_scanner_peek(scanner, q)) >= 0 &&
+        TURTLE_CLASS(c, TURTLE_CLASS_ALPHA))
+    q++;
+  if(q == p + 1)
+    return 0;
+
+  while(c == '-' || c == '_') {
+    const unsigned char* r = q + 1;
+
+    while((c = turtle_scanner_peek(scanner, r)) >= 0 &&
+          TURTLE_CLASS(c, TURTLE_CLASS_ALPHA | TURTLE_CLASS_DIGIT))
+      r++;
+    if(r == q + 1)
+      break;
+    q = r;
+  }
+
+  return RAPTOR_GOOD_CAST(size_t, q - p);
+}
+
+
+/* IRI: "<" ([^\x00-\x20<>"{}|^`\\] | UCHAR)* ">" */
+static size_t
+turtle_scanner_scan_iri(turtle_scanner* scanner, const unsigned char* p,
+                        int* escaped_p)
+{
+  const unsigned char* q = p + 1;
+
+  *escaped_p = 0;
+  while(1) {
+    int c;
+    int hex_count;
+    int i;
+
+    while(q < scanner->limit && TURTLE_CLASS(*q, TURTLE_CLASS_IRI))
+      q++;
+
+    c = turtle_scanner_peek(scanner, q);
+    if(c == '>')
+      return RAPTOR_GOOD_CAST(size_t, q + 1 - p);
+    if(c != '\\')
+      return 0;
+
+    c = turtle_scanner_peek(scanner, q + 1);
+    if(c == 'u')
+      hex_count = 4;
+    else if(c == 'U')
+      hex_count = 8;
+    else
+      return 0;
+
+    for(i = 0; i < hex_count; i++) {
+      c = turtle_scanner_peek(scanner, q + 2 + i);
+      if(c < 0 || !TURTLE_CLASS(c, TURTLE_CLASS_HEX))
+        return 0;
+    }
+    q += 2 + hex_count;
+    *escaped_p = 1;
+  }
+}
+
+
+/* After an IRI or QName: [ \t\v\r\n]* "="? [ \t\v\r\n]* "{" */
+static size_t
+turtle_scanner_scan_graph_open(turtle_scanner* scanner,
+                               const unsigned char* p)
+{
+  const unsigned char* q = p;
+  int c;
+  int seen_equals = 0;
+
+  while(1) {
+    c = turtle_scanner_peek(scanner, q);
+    if(c == ' ' || c == '\t' || c == '\v' || c == '\r' || c == '\n')
+      q++;
+    else if(c == '=' && !seen_equals) {
+      seen_equals = 1;
+      q++;
+    } else
+      break;
+  }
+
+  return (c == '{') ? RAPTOR_GOOD_CAST(size_t, q + 1 - p) : 0;
+}
+
+
+/* length of @keyword at @p, compared ignoring ASCII case if @nocase */
+static size_t
+turtle_scanner_match_keyword(turtle_scanner* scanner, const unsigned char* p,
+                             const char* keyword, int nocase)
+{
+  size_t i;
+
+  for(i = 0; keyword[i]; i++) {
+    int c = turtle_scanner_peek(scanner, p + i);
+
+    if(nocase && c >= 'A' && c <= 'Z')
+      c += 'a' - 'A';
+    if(c != keyword[i])
+      return 0;
+  }
+
+  return i;
+}
+
+
+static unsigned char*
+turtle_scanner_copy_token(const unsigned char* text, size_t len)
+{
+  unsigned char* s;
+
+  s = RAPTOR_MALLOC(unsigned char*, len + 1);
+  if(s) {
+    memcpy(s, text, len);
+    s[len] = '\0';
+  }
+
+  return s;
+}
+
+
+static void
+turtle_scanner_fatal_error(turtle_scanner* scanner, const char* message)
+{
+  raptor_parser_log_error(scanner->rdf_parser, RAPTOR_LOG_LEVEL_FATAL,
+                          "%s", message);
+}
+
+
+/* Make a URI for an IRI token body; NULL on failure */
+static raptor_uri*
+turtle_scanner_iri_to_uri(turtle_scanner* scanner, unsigned char* text,
+                          size_t len, int escaped)
+{
+  raptor_parser* rdf_parser = scanner->rdf_parser;
+  raptor_uri* uri;
+
+  if(!len)
+    return raptor_uri_copy(rdf_parser->base_uri);
+
+  if(!escaped) {
+    /* plain IRI: resolve straight from the input buffer */
+    unsigned char save = text[len];
+
+    text[len] = '\0';
+    uri = raptor_new_uri_relative_to_base_counted(rdf_parser->world,
+                                                  rdf_parser->base_uri,
+                                                  text, len);
+    text[len] = save;
+  } else {
+    unsigned char* uri_string;
+    size_t uri_len;
+
+    uri_string = raptor_turtle_decode_string(text, len, '>',
+                                             (raptor_simple_message_handler)turtle_lexer_syntax_error,
+                                             rdf_parser, 1, &uri_len);
+    if(!uri_string) {
+      turtle_scanner_fatal_error(scanner,
+                                 "raptor_turtle_decode_string failed");
+      return NULL;
+    }
+
+    if(!uri_len)
+      uri = raptor_uri_copy(rdf_parser->base_uri);
+    else
+      uri = raptor_new_uri_relative_to_base_counted(rdf_parser->world,
+                                                    rdf_parser->base_uri,
+                                                    uri_string, uri_len);
+    RAPTOR_FREE(char*, uri_string);
+  }
+
+  if(!uri)
+    turtle_scanner_fatal_error(scanner, "Out of memory");
+
+  return uri;
+}
+
+
+/* Make a URI for a QName token; NULL on failure */
+static raptor_uri*
+turtle_scanner_qname_to_uri(turtle_scanner* scanner, unsigned char* text,
+                            size_t len)
+{
+  raptor_uri* uri;
+  unsigned char save = text[len];
+
+  /* turtle_qname_to_uri() expands escapes in place and needs a NUL */
+  text[len] = '\0';
+  uri = turtle_qname_to_uri(scanner->rdf_parser, text, len);
+  if(!uri)
+    raptor_parser_log_error(scanner->rdf_parser, RAPTOR_LOG_LEVEL_ERROR,
+                            "Failed to convert qname %s to URI", text);
+  text[len] = save;
+
+  return uri;
+}
+
+
+/* "..." '...' """...""" or '''...''' */
+static int
+turtle_scanner_string(turtle_scanner* scanner, unsigned char* p,
+                      TURTLE_PARSER_STYPE *lval, size_t* len_p)
+{
+  raptor_parser* rdf_parser = scanner->rdf_parser;
+  raptor_turtle_parser* turtle_parser = (raptor_turtle_parser*)rdf_parser->context;
+  int delim = *p;
+  int is_single = (delim == '\'');
+  unsigned char* content;
+  unsigned char* q;
+  int escaped = 0;
+  int c;
+  int c1;
+
+  c1 = turtle_scanner_peek(scanner, p + 1);
+  c = (c1 == delim) ? turtle_scanner_peek(scanner, p + 2) : -1;
+  if(scanner->more)
+    return TURTLE_SCANNER_MORE;
+
+  if(c1 == delim && c == delim) {
+    /* long string: up to the first unescaped triple delimiter */
+    const raptor_scan_set* set = &scanner->long_string_delims[is_single];
+    size_t lines = 0;
+
+    content = p + 3;
+    q = content + scanner->resume;
+    while(1) {
+      q = RAPTOR_BAD_CAST(unsigned char*,
+                          raptor_scan_set_find(set, q, scanner->limit));
+      c = turtle_scanner_peek(scanner, q);
+      if(c == delim) {
+        int c2;
+
+        c1 = turtle_scanner_peek(scanner, q + 1);
+        c2 = (c1 == delim) ? turtle_scanner_peek(scanner, q + 2) : -1;
+
+        if(scanner->more)
+          break;
+        if(c1 == delim && c2 == delim)
+          break;
+        q++;
+        continue;
+      }
+      if(c == '\\') {
+        c = turtle_scanner_peek(scanner, q + 1);
+        if(c < 0 || c == '\n')
+          break;
+        q += 2;
+        escaped = 1;
+        continue;
+      }
+      break;
+    }
+
+    if(scanner->more) {
+      scanner->resume = RAPTOR_GOOD_CAST(size_t, q - content);
+      return TURTLE_SCANNER_MORE;
+    }
+    scanner->resume = 0;
+
+    if(c != delim) {
+      /* end of input or \ before a newline */
+      *len_p = RAPTOR_GOOD_CAST(size_t, (c < 0 ? scanner->limit : q + 2) - p);
+      if(is_single)
+        turtle_syntax_error(rdf_parser,
+                            "End of file in middle of '''literal'''");
+      else
+        turtle_syntax_error(rdf_parser,
+                            "End of file in middle of \"\"\"literal\"\"\"");
+      return 0;
+    }
+
+    *len_p = RAPTOR_GOOD_CAST(size_t, q + 3 - p);
+    for(p = content;
+        (p = RAPTOR_GOOD_CAST(unsigned char*,
+                              memchr(p, '\n', RAPTOR_GOOD_CAST(size_t, q - p))));
+        p++)
+      lines++;
+    turtle_parser->lineno += RAPTOR_BAD_CAST(int, lines);
+  } else {
+    const raptor_scan_set* set = &scanner->string_delims[is_single];
+
+    content = p + 1;
+    q = content;
+    while(1) {
+      q = RAPTOR_BAD_CAST(unsigned char*,
+                          raptor_scan_set_find(set, q, scanner->limit));
+      c = turtle_scanner_peek(scanner, q);
+      if(c != '\\')
+        break;
+      c = turtle_scanner_peek(scanner, q + 1);
+      if(c < 0 || c == '\n' || c == '\r')
+        break;
+      q += 2;
+      escaped = 1;
+    }
+    if(scanner->more)
+      return TURTLE_SCANNER_MORE;
+
+    if(c != delim) {
+      *len_p = 1;
+      turtle_syntax_error(rdf_parser, "syntax error at '%c'", delim);
+      return 0;
+    }
+
+    *len_p = RAPTOR_GOOD_CAST(size_t, q + 1 - p);
+  }
+
+  if(escaped) {
+    size_t len;
+
+    /* both kinds of quote are decoded as for "" as flex does */
+    lval->string = raptor_turtle_decode_string(content,
+                                               RAPTOR_GOOD_CAST(size_t, q - content),
+                                               '"',
+                                               (raptor_simple_message_handler)turtle_lexer_syntax_error,
+                                               rdf_parser, 0, &len);
+  } else
+    lval->string = turtle_scanner_copy_token(content,
+                                             RAPTOR_GOOD_CAST(size_t, q - content));
+
+  return lval->string ? STRING_LITERAL : 0;
+}
+
+
+/* Scan one token at @p: a token, 0 after an error or EOF for a NUL,
+ * or TURTLE_SCANNER_SKIP or TURTLE_SCANNER_MORE.  *@len_p is set to
+ * the bytes consumed for all but TURTLE_SCANNER_MORE.
+ */
+static int
+turtle_scanner_token(turtle_scanner* scanner, unsigned char* p,
+                     TURTLE_PARSER_STYPE *lval, size_t* len_p)
+{
+  raptor_parser* rdf_parser = scanner->rdf_parser;
+  raptor_turtle_parser* turtle_parser = (raptor_turtle_parser*)rdf_parser->context;
+  int c = *p;
+  size_t n;
+  int token;
+  int escaped;
+
+  *len_p = 1;
+
+  if(TURTLE_CLASS(c, TURTLE_CLASS_SPACE)) {
+    const unsigned char* q = p + 1;
+
+    while(q < scanner->limit && TURTLE_CLASS(*q, TURTLE_CLASS_SPACE))
+      q++;
+    *len_p = RAPTOR_GOOD_CAST(size_t, q - p);
+    return TURTLE_SCANNER_SKIP;
+  }
+
+  if(scanner->in_prefix) {
+    /* after @prefix: the prefix name with ':' or a syntax error */
+    if(TURTLE_CLASS(c, TURTLE_CLASS_NAME_START)) {
+      n = 1 + turtle_scanner_scan_name_rest(scanner, p + 1, 0);
+      c = turtle_scanner_peek(scanner, p + n);
+      if(scanner->more)
+        return TURTLE_SCANNER_MORE;
+      if(c == ':')
+        n++;
+      else
+        n = 0;
+    } else
+      n = (c == ':') ? 1 : 0;
+
+    scanner->in_prefix = 0;
+    if(n) {
+      lval->string = turtle_scanner_copy_token(p, n);
+      if(!lval->string) {
+        turtle_scanner_fatal_error(scanner, "turtle_copy_token failed");
+        return 0;
+      }
+      *len_p = n;
+      return IDENTIFIER;
+    }
+
+    if(!*p)
+      return EOF;
+    turtle_syntax_error(rdf_parser, "syntax error at '%c'", *p);
+    return 0;
+  }
+
+  switch(c) {
+    case '\n':
+      turtle_parser->lineno++;
+      return TURTLE_SCANNER_SKIP;
+
+    case '\r':
+      c = turtle_scanner_peek(scanner, p + 1);
+      if(scanner->more)
+        return TURTLE_SCANNER_MORE;
+      if(c == '\n')
+        *len_p = 2;
+      turtle_parser->lineno++;
+      return TURTLE_SCANNER_SKIP;
+
+    case '#':
+      {
+        const unsigned char* q;
+
+        q = raptor_scan_set_find(&scanner->eol_delims, p + 1, scanner->limit);
+        c = turtle_scanner_peek(scanner, q);
+        if(c == '\r' && turtle_scanner_peek(scanner, q + 1) == '\n')
+          q++;
+        if(scanner->more)
+          return TURTLE_SCANNER_MORE;
+        if(c >= 0) {
+          turtle_parser->lineno++;
+          q++;
+        }
+        *len_p = RAPTOR_GOOD_CAST(size_t, q - p);
+      }
+      return TURTLE_SCANNER_SKIP;
+
+    case ',':
+      return COMMA;
+    case ';':
+      return SEMICOLON;
+    case '[':
+      return LEFT_SQUARE;
+    case ']':
+      return RIGHT_SQUARE;
+    case '(':
+      return LEFT_ROUND;
+    case ')':
+      return RIGHT_ROUND;
+    case '{':
+      return LEFT_CURLY;
+    case '}':
+      return RIGHT_CURLY;
+
+    case '^':
+      c = turtle_scanner_peek(scanner, p + 1);
+      if(scanner->more)
+        return TURTLE_SCANNER_MORE;
+      if(c == '^') {
+        *len_p = 2;
+        return HAT;
+      }
+      break;
+
+    case '"':
+    case '\'':
+      return turtle_scanner_string(scanner, p, lval, len_p);
+
+    case '<':
+      {
+        size_t iri_len;
+
+        iri_len = turtle_scanner_scan_iri(scanner, p, &escaped);
+        if(!iri_len) {
+          if(scanner->more)
+            return TURTLE_SCANNER_MORE;
+          break;
+        }
+
+        token = URI_LITERAL;
+        n = turtle_scanner_scan_graph_open(scanner, p + iri_len);
+        if(scanner->more)
+          return TURTLE_SCANNER_MORE;
+        if(n)
+          token = GRAPH_NAME_LEFT_CURLY;
+        *len_p = iri_len + n;
+
+        /* between the '<' and '>' */
+        lval->uri = turtle_scanner_iri_to_uri(scanner, p + 1, iri_len - 2,
+                                              escaped);
+        return lval->uri ? token : 0;
+      }
+
+    case '@':
+      n = turtle_scanner_scan_langtag(scanner, p);
+      if(scanner->more)
+        return TURTLE_SCANNER_MORE;
+      if(n == 7 && !memcmp(p, "@prefix", 7)) {
+        *len_p = n;
+        scanner->in_prefix = 1;
+        return PREFIX;
+      }
+      if(n == 5 && !memcmp(p, "@base", 5)) {
+        *len_p = n;
+        return BASE;
+      }
+      if(!n)
+        break;
+
+      lval->string = turtle_scanner_copy_token(p + 1, n - 1);
+      if(!lval->string) {
+        turtle_scanner_fatal_error(scanner, "turtle_copy_token failed");
+        return 0;
+      }
+      *len_p = n;
+      return LANGTAG;
+
+    case '_':
+      c = turtle_scanner_peek(scanner, p + 1);
+      if(c == ':') {
+        c = turtle_scanner_peek(scanner, p + 2);
+        if(c >= 0 && TURTLE_CLASS_LABEL_START(c))
+          n = 3 + turtle_scanner_scan_name_rest(scanner, p + 3, 0);
+        else
+          n = 0;
+      } else
+        n = 0;
+      if(scanner->more)
+        return TURTLE_SCANNER_MORE;
+      if(!n)
+        break;
+
+      lval->string = turtle_scanner_copy_token(p + 2, n - 2);
+      if(!lval->string) {
+        turtle_scanner_fatal_error(scanner, "turtle_copy_token failed");
+        return 0;
+      }
+      *len_p = n;
+      return BLANK_LITERAL;
+
+    case '\0':
+      return EOF;
+
+    default:
+      break;
+  }
+
+  if(c == '.' || c == '+' || c == '-' ||
+     TURTLE_CLASS(c, TURTLE_CLASS_DIGIT)) {
+    token = turtle_scanner_scan_number(scanner, p, len_p);
+    if(scanner->more)
+      return TURTLE_SCANNER_MORE;
+    if(token) {
+      lval->string = turtle_scanner_copy_token(p, *len_p);
+      if(!lval->string) {
+        turtle_scanner_fatal_error(scanner, "turtle_copy_token failed");
+        return 0;
+      }
+      return token;
+    }
+    *len_p = 1;
+    if(c == '.')
+      return DOT;
+  }
+
+  if(c == ':' || TURTLE_CLASS(c, TURTLE_CLASS_NAME_START)) {
+    n = turtle_scanner_scan_qname(scanner, p);
+    if(scanner->more)
+      return TURTLE_SCANNER_MORE;
+
+    if(n) {
+      size_t qname_len = n;
+
+      token = QNAME_LITERAL;
+      n = turtle_scanner_scan_graph_open(scanner, p + qname_len);
+      if(scanner->more)
+        return TURTLE_SCANNER_MORE;
+      if(n)
+        token = GRAPH_NAME_LEFT_CURLY;
+      *len_p = qname_len + n;
+
+      lval->uri = turtle_scanner_qname_to_uri(scanner, p, qname_len);
+      return lval->uri ? token : 0;
+    }
+
+    /* keywords that are not QNames */
+    token = 0;
+    if((n = turtle_scanner_match_keyword(scanner, p, "a", 0)))
+      token = A;
+    else if((n = turtle_scanner_match_keyword(scanner, p, "true", 0)))
+      token = TRUE_TOKEN;
+    else if((n = turtle_scanner_match_keyword(scanner, p, "false", 0)))
+      token = FALSE_TOKEN;
+    else if((n = turtle_scanner_match_keyword(scanner, p, "prefix", 1))) {
+      scanner->in_prefix = 1;
+      token = SPARQL_PREFIX;
+    } else if((n = turtle_scanner_match_keyword(scanner, p, "base", 1)))
+      token = SPARQL_BASE;
+    if(scanner->more)
+      return TURTLE_SCANNER_MORE;
+
+    if(token) {
+      *len_p = n;
+      return token;
+    }
+  }
+
+  turtle_syntax_error(rdf_parser, "syntax error at '%c'", c);
+  *len_p = 1;
+  return 0;
+}
+
+
+/*
+ * turtle_scanner_lex:
+ * @scanner: scanner
+ * @lval: token value to set
+ * @is_end: non-0 if there is no more input to come
+ *
+ * INTERNAL - Get the next token from the scanner
+ *
+ * Returns the same tokens as turtle_lexer_lex().  0 is returned when
+ * no complete token is available yet, at the end of input or after
+ * an error has been reported.
+ *
+ * Return value: token or 0
+ */
+int
+turtle_scanner_lex(turtle_scanner* scanner, TURTLE_PARSER_STYPE *lval,
+                   int is_end)
+{
+  if(!scanner->buffer)
+    return 0;
+
+  scanner->limit = scanner->buffer + scanner->end;
+  scanner->is_end = is_end;
+
+  while(scanner->start < scanner->end) {
+    size_t len;
+    int token;
+
+    scanner->more = 0;
+    token = turtle_scanner_token(scanner, scanner->buffer + scanner->start,
+                                 lval, &len);
+    if(token == TURTLE_SCANNER_MORE)
+      break;
+
+    scanner->start += len;
+    if(token != TURTLE_SCANNER_SKIP)
+      return token;
+  }
+
+  return 0;
+}
+
+
+#endif /* !STANDALONE */
+
+
+#ifdef STANDALONE
+
+/* one more prototype */
+int main(int argc, char *argv[]);
+
+
+static const char * const base_uri_string = "http://example.org/base/";
+
+static const struct {
+  const char* input;
+  const char* tokens;
+  int lines;
+  int errors;
+} turtle_scanner_tests[] = {
+  { "@prefix ex: <http://example.org/ns#> .\n",
+    "PREFIX IDENTIFIER(ex:) URI(http://example.org/ns#) DOT",
+    1, 0 },
+  { "ex:s a ex:C ;\n  ex:p \"x\"@en-GB , 'y' , \"\"\"long \"quoted\"\nline\"\"\" .",
+    "QNAME(http://example.org/ns#s) A QNAME(http://example.org/ns#C) SEMICOLON QNAME(http://example.org/ns#p) STRING(x) LANGTAG(en-GB) COMMA STRING(y) COMMA STRING(long \"quoted\"\nline) DOT",
+    2, 0 },
+  { "1 -2 +3.5 .5 1.e5 1e-3 4.",
+    "INTEGER(1) INTEGER(-2) DECIMAL(+3.5) DECIMAL(.5) FLOATING(1.e5) FLOATING(1e-3) INTEGER(4) DOT",
+    0, 0 },
+  { "_:b1.x _:b. true false PREFIX : <> BASE <a> @base",
+    "BLANK(b1.x) BLANK(b) DOT TRUE FALSE SPARQL_PREFIX IDENTIFIER(:) URI(http://example.org/base/) SPARQL_BASE URI(http://example.org/base/a) BASE",
+    0, 0 },
+  { "<g> { ex:g = { }",
+    "GRAPH(http://example.org/base/g) GRAPH(http://example.org/ns#g) RIGHT_CURLY",
+    0, 0 },
+  { "<http://example.org/\\u0041> \"a\\tb\" ex:a\\.b ex:c%20d",
+    "URI(http://example.org/A) STRING(a\tb) QNAME(http://example.org/ns#a.b) QNAME(http://example.org/ns#c%20d)",
+    0, 0 },
+  { "# comment\r\n\"1\"^^ex:int ( ) [ ] # last",
+    "STRING(1) HAT QNAME(http://example.org/ns#int) LEFT_ROUND RIGHT_ROUND LEFT_SQUARE RIGHT_SQUARE",
+    1, 0 },
+  { "ex:a ? ex:b",
+    "QNAME(http://example.org/ns#a)",
+    0, 1 },
+  { "ex:s A ex:C",
+    "QNAME(http://example.org/ns#s)",
+    0, 1 },
+  { "\"\"\"unterminated",
+    "",
+    0, 1 },
+  { NULL, NULL, 0, 0 }
+};
+
+
+static void
+turtle_scanner_test_log_handler(void *user_data, raptor_log_message *message)
+{
+  int* errors_p = (int*)user_data;
+
+  (*errors_p)++;
+}
+
+
+/* append a token and its value to @sb and free the value */
+static void
+turtle_scanner_test_format(raptor_stringbuffer* sb, int token,
+                           TURTLE_PARSER_STYPE *lval)
+{
+  const char* name = NULL;
+  unsigned char* string = NULL;
+  raptor_uri* uri = NULL;
+
+  switch(token) {
+    case A: name = "A"; break;
+    case HAT: name = "HAT"; break;
+    case DOT: name = "DOT"; break;
+    case COMMA: name = "COMMA"; break;
+    case SEMICOLON: name = "SEMICOLON"; break;
+    case LEFT_SQUARE: name = "LEFT_SQUARE"; break;
+    case RIGHT_SQUARE: name = "RIGHT_SQUARE"; break;
+    case LEFT_ROUND: name = "LEFT_ROUND"; break;
+    case RIGHT_ROUND: name = "RIGHT_ROUND"; break;
+    case LEFT_CURLY: name = "LEFT_CURLY"; break;
+    case RIGHT_CURLY: name = "RIGHT_CURLY"; break;
+    case TRUE_TOKEN: name = "TRUE"; break;
+    case FALSE_TOKEN: name = "FALSE"; break;
+    case PREFIX: name = "PREFIX"; break;
+    case BASE: name = "BASE"; break;
+    case SPARQL_PREFIX: name = "SPARQL_PREFIX"; break;
+    case SPARQL_BASE: name = "SPARQL_BASE"; break;
+    case STRING_LITERAL: name = "STRING"; string = lval->string; break;
+    case IDENTIFIER: name = "IDENTIFIER"; string = lval->string; break;
+    case LANGTAG: name = "LANGTAG"; string = lval->string; break;
+    case INTEGER_LITERAL: name = "INTEGER"; string = lval->string; break;
+    case FLOATING_LITERAL: name = "FLOATING"; string = lval->string; break;
+    case DECIMAL_LITERAL: name = "DECIMAL"; string = lval->string; break;
+    case BLANK_LITERAL: name = "BLANK"; string = lval->string; break;
+    case URI_LITERAL: name = "URI"; uri = lval->uri; break;
+    case GRAPH_NAME_LEFT_CURLY: name = "GRAPH"; uri = lval->uri; break;
+    case QNAME_LITERAL: name = "QNAME"; uri = lval->uri; break;
+    default: name = "UNKNOWN"; break;
+  }
+
+  if(raptor_stringbuffer_length(sb))
+    raptor_stringbuffer_append_counted_string(sb, (const unsigned char*)" ",
+                                              1, 1);
+  raptor_stringbuffer_append_string(sb, (const unsigned char*)name, 1);
+  if(string || uri) {
+    raptor_stringbuffer_append_counted_string(sb, (const unsigned char*)"(",
+                                              1, 1);
+    raptor_stringbuffer_append_string(sb, string ? string : raptor_uri_as_string(uri), 1);
+    raptor_stringbuffer_append_counted_string(sb, (const unsigned char*)")",
+                                              1, 1);
+  }
+
+  if(string)
+    RAPTOR_FREE(char*, string);
+  if(uri)
+    raptor_free_uri(uri);
+}
+
+
+/* scan @input given in chunks of @step bytes (all at once if 0) */
+static unsigned char*
+turtle_scanner_test_scan(raptor_parser* rdf_parser, const char* input,
+                         size_t step)
+{
+  raptor_turtle_parser* turtle_parser = (raptor_turtle_parser*)rdf_parser->context;
+  turtle_scanner* scanner;
+  raptor_stringbuffer* sb;
+  unsigned char* result;
+  size_t len = strlen(input);
+  size_t offset = 0;
+  int is_end = 0;
+
+  scanner = turtle_new_scanner(rdf_parser);
+  sb = raptor_new_stringbuffer();
+  if(!scanner || !sb)
+    return NULL;
+
+  turtle_parser->lineno = 0;
+  turtle_parser->error_count = 0;
+
+  while(!is_end && !turtle_parser->error_count) {
+    size_t n = (step && len - offset > step) ? step : len - offset;
+    TURTLE_PARSER_STYPE lval;
+    int token;
+
+    turtle_scanner_append(scanner, (const unsigned char*)input + offset, n);
+    offset += n;
+    is_end = (offset == len);
+
+    while((token = turtle_scanner_lex(scanner, &lval, is_end)))
+      turtle_scanner_test_format(sb, token, &lval);
+  }
+
+  result = RAPTOR_MALLOC(unsigned char*, raptor_stringbuffer_length(sb) + 1);
+  if(result)
+    raptor_stringbuffer_copy_to_string(sb, result,
+                                       raptor_stringbuffer_length(sb) + 1);
+
+  raptor_free_stringbuffer(sb);
+  turtle_free_scanner(scanner);
+
+  return result;
+}
+
+
+int
+main(int argc, char *argv[])
+{
+  const char *program = raptor_basename(argv[0]);
+  static const size_t steps[3] = { 0, 1, 7 };
+  raptor_world *world;
+  raptor_parser* rdf_parser;
+  raptor_turtle_parser* turtle_parser;
+  raptor_uri* base_uri;
+  int errors = 0;
+  int failures = 0;
+  int i;
+
+  world = raptor_new_world();
+  if(!world || raptor_world_open(world))
+    exit(1);
+
+  raptor_world_set_log_handler(world, &errors,
+                               turtle_scanner_test_log_handler);
+
+  rdf_parser = raptor_new_parser(world, "turtle");
+  base_uri = raptor_new_uri(world, (const unsigned char*)base_uri_string);
+  if(!rdf_parser || !base_uri || raptor_parser_parse_start(rdf_parser, base_uri)) {
+    fprintf(stderr, "%s: Failed to start a turtle parser\n", program);
+    exit(1);
+  }
+  turtle_parser = (raptor_turtle_parser*)rdf_parser->context;
+
+  /* the grammar declares prefixes; do it here instead */
+  raptor_namespaces_start_namespace_full(&turtle_parser->namespaces,
+                                         (const unsigned char*)"ex",
+                                         (const unsigned char*)"http://example.org/ns#",
+                                         0);
+
+  for(i = 0; turtle_scanner_tests[i].input; i++) {
+    int s;
+
+    for(s = 0; s < 3; s++) {
+      unsigned char* tokens;
+
+      errors = 0;
+      tokens = turtle_scanner_test_scan(rdf_parser,
+                                        turtle_scanner_tests[i].input,
+                                        steps[s]);
+      if(!tokens) {
+        fprintf(stderr, "%s: Test %d scan failed\n", program, i);
+        failures++;
+        continue;
+      }
+
+      if(strcmp((const char*)tokens, turtle_scanner_tests[i].tokens)) {
+        fprintf(stderr,
+                "%s: Test %d step %d returned tokens\n  %s\nexpected\n  %s\n",
+                program, i, (int)steps[s], tokens,
+                turtle_scanner_tests[i].tokens);
+        failures++;
+      } else if(turtle_parser->lineno != turtle_scanner_tests[i].lines) {
+        fprintf(stderr, "%s: Test %d step %d counted %d lines expected %d\n",
+                program, i, (int)steps[s], turtle_parser->lineno,
+                turtle_scanner_tests[i].lines);
+        failures++;
+      } else if((errors > 0) != (turtle_scanner_tests[i].errors > 0)) {
+        fprintf(stderr, "%s: Test %d step %d gave %d errors expected %d\n",
+                program, i, (int)steps[s], errors,
+                turtle_scanner_tests[i].errors);
+        failures++;
+      }
+
+      RAPTOR_FREE(char*, tokens);
+    }
+  }
+
+  raptor_free_uri(base_uri);
+  raptor_free_parser(rdf_parser);
+  raptor_free_world(world);
+
+  return failures;
+}
+
+#endif
+
@@ -0,0 +1,872 @@
+/* -*- Mode: c; c-basic-offset: 2 -*-
+ *
+ * raptor_bench.c - Raptor parser and serializer throughput benchmarks
+ *
+ * Copyright (C) 2026, David Beckett http://www.dajobe.org/
+ *
+ * This package is Free Software and part of Redland http://librdf.org/
+ *
+ * It is licensed under the following three licenses as alternatives:
+ *   1. GNU Lesser General Public License (LGPL) V2.1 or any newer version
+ *   2. GNU General Public License (GPL) V2 or any newer version
+ *   3. Apache License, V2.0 or any newer version
+ *
+ * You may not use this file except in compliance with at least one of
+ * the above three licenses.
+ *
+ * See LICENSE.html or LICENSE.txt at the top of this package for the
+ * complete terms and further detail along with the license texts for
+ * the licenses in COPYING.LIB, COPYING and LICENSE-2.0.txt respectively.
+ *
+ *
+ * Each workload is a document in some syntax: a synthetic N-Triples
+ * document or a FILE from the command line.  The benchmarks for a
+ * workload are:
+ *
+ *   parse      the workload document with its parser
+ *   serialize  the workload statements with every serializer
+ *   parse      each serializer output that has a parser of the same name
+ *
+ * One JSON object per benchmark is written to stdout on its own line.
+ * See README.md for the fields.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <raptor_config.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#ifdef HAVE_SYS_TIME_H
+#include <sys/time.h>
+#endif
+#ifdef HAVE_SYS_RESOURCE_H
+#include <sys/resource.h>
+#endif
+
+#include <raptor2.h>
+
+
+/*
+ * Allocation counting
+ *
+ * With glibc, malloc and friends are replaced here with versions that
+ * count calls and pass them on to the glibc allocator.  Definitions in
+ * the program take precedence over those in libc for the raptor
+ * library and its dependencies too.  Not done under sanitizers, which
+ * replace the allocator themselves.
+ */
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__) && !defined(__SANITIZE_THREAD__)
+#define BENCH_COUNT_ALLOCATIONS 1
+#if defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(thread_sanitizer) || __has_feature(memory_sanitizer)
+#undef BENCH_COUNT_ALLOCATIONS
+#endif
+#endif
+#endif
+
+#ifdef BENCH_COUNT_ALLOCATIONS
+static unsigned long bench_allocations = 0;
+
+#ifdef HAVE_ATOMIC_BUILTINS
+#define BENCH_COUNT_ALLOCATION() \
+  __atomic_add_fetch(&bench_allocations, 1, __ATOMIC_RELAXED)
+#else
+#define BENCH_COUNT_ALLOCATION() bench_allocations++
+#endif
+
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t nmemb, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+extern void __libc_free(void* ptr);
+
+void*
+malloc(size_t size)
+{
+  BENCH_COUNT_ALLOCATION();
+  return __libc_malloc(size);
+}
+
+void*
+calloc(size_t nmemb, size_t size)
+{
+  BENCH_COUNT_ALLOCATION();
+  return __libc_calloc(nmemb, size);
+}
+
+void*
+realloc(void* ptr, size_t size)
+{
+  BENCH_COUNT_ALLOCATION();
+  return __libc_realloc(ptr, size);
+}
+
+void
+free(void* ptr)
+{
+  __libc_free(ptr);
+}
+
+/* allocations so far or -1 if not counted */
+static long
+bench_get_allocations(void)
+{
+  return (long)bench_allocations;
+}
+#else
+static long
+bench_get_allocations(void)
+{
+  return -1;
+}
+#endif
+
+
+/* wall clock time in seconds */
+static double
+bench_get_time(void)
+{
+#ifdef HAVE_GETTIMEOFDAY
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return (double)tv.tv_sec + (double)tv.tv_usec / 1e6;
+#else
+  return (double)time(NULL);
+#endif
+}
+
+
+/* process CPU time in seconds */
+static double
+bench_get_cpu_time(void)
+{
+#ifdef HAVE_GETRUSAGE
+  struct rusage usage;
+
+  getrusage(RUSAGE_SELF, &usage);
+  return (double)usage.ru_utime.tv_sec + (double)usage.ru_utime.tv_usec / 1e6 +
+         (double)usage.ru_stime.tv_sec + (double)usage.ru_stime.tv_usec / 1e6;
+#else
+  return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+
+/* reset the peak RSS to the current RSS where the system allows it */
+static void
+bench_reset_peak_rss(void)
+{
+#ifdef __linux__
+  FILE* fh = fopen("/proc/self/clear_refs", "w");
+  if(fh) {
+    fputs("5", fh);
+    fclose(fh);
+  }
+#endif
+}
+
+
+/* peak resident set size in kilobytes or -1 if unknown */
+static long
+bench_get_peak_rss(void)
+{
+#ifdef __linux__
+  FILE* fh = fopen("/proc/self/status", "r");
+  if(fh) {
+    char line[128];
+    long kb = -1;
+
+    while(fgets(line, sizeof(line), fh)) {
+      if(!strncmp(line, "VmHWM:", 6)) {
+        kb = strtol(line + 6, NULL, 10);
+        break;
+      }
+    }
+    fclose(fh);
+    if(kb >= 0)
+      return kb;
+  }
+#endif
+#ifdef HAVE_GETRUSAGE
+  {
+    struct rusage usage;
+
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    /* bytes */
+    return (long)(usage.ru_maxrss / 1024);
+#else
+    return (long)usage.ru_maxrss;
+#endif
+  }
+#else
+  return -1;
+#endif
+}
+
+
+/*
+ * Synthetic workloads, written as N-Triples
+ */
+
+#define EX "http://example.org/"
+#define RDF "http://www.w3.org/1999/02/22-rdf-syntax-ns#"
+#define XSD "http://www.w3.org/2001/XMLSchema#"
+
+static void
+bench_append(raptor_stringbuffer* sb, const char* string)
+{
+  raptor_stringbuffer_append_string(sb, (const unsigned char*)string, 1);
+}
+
+
+/* URIs and short plain, language and datatyped literals */
+static int
+bench_generate_plain(raptor_stringbuffer* sb, int count)
+{
+  int i;
+
+  for(i = 0; i < count; i++) {
+    char line[256];
+    int s = i / 8;
+
+    switch(i % 4) {
+      case 0:
+        sprintf(line, "<" EX "s%d> <" EX "p%d> <" EX "o%d> .\n",
+                s, i % 8, i);
+        break;
+      case 1:
+        sprintf(line, "<" EX "s%d> <" EX "p%d> \"literal %d\" .\n",
+                s, i % 8, i);
+        break;
+      case 2:
+        sprintf(line, "<" EX "s%d> <" EX "p%d> \"cha\\u00EEne %d\"@fr .\n",
+                s, i % 8, i);
+        break;
+      default:
+        sprintf(line, "<" EX "s%d> <" EX "p%d> \"%d\"^^<" XSD "integer> .\n",
+                s, i % 8, i);
+        break;
+    }
+    bench_append(sb, line);
+  }
+
+  return count;
+}
+
+
+/* literals of a few kilobytes with escapes and non-ASCII text */
+static int
+bench_generate_long_literals(raptor_stringbuffer* sb, int count)
+{
+  char line[128];
+  int i;
+
+  /* fewer statements so the document is a similar size to the others */
+  count = count / 16 + 1;
+
+  for(i = 0; i < count; i++) {
+    int j;
+
+    sprintf(line, "<" EX "doc%d> <" EX "text> \"", i);
+    bench_append(sb, line);
+    for(j = 0; j < 40; j++)
+      bench_append(sb, "The quick brown fox \\\"jumps\\\" over the lazy dog,\\n"
+                   "na\xc3\xafve caf\xc3\xa9 \xe2\x82\xac\\t\\u00E9t\\u00E9. ");
+    sprintf(line, "%d\" .\n", i);
+    bench_append(sb, line);
+  }
+
+  return count;
+}
+
+
+/* a graph of blank nodes */
+static int
+bench_generate_bnodes(raptor_stringbuffer* sb, int count)
+{
+  int nodes = count / 2 + 1;
+  int i;
+
+  for(i = 0; i < nodes; i++) {
+    char line[256];
+
+    sprintf(line, "_:b%d <" EX "p%d> _:b%d .\n_:b%d <" EX "label> \"node %d\" .\n",
+            i, i % 4, (i * 7 + 1) % nodes, i, i);
+    bench_append(sb, line);
+  }
+
+  return nodes * 2;
+}
+
+
+#define BENCH_COLLECTION_DEPTH 32
+#define BENCH_COLLECTION_LENGTH 16
+
+/* RDF collections, nested BENCH_COLLECTION_DEPTH deep with the
+ * innermost a list of BENCH_COLLECTION_LENGTH items */
+static int
+bench_generate_collections(raptor_stringbuffer* sb, int count)
+{
+  int statements = 0;
+  int c;
+
+  for(c = 0; statements < count; c++) {
+    char line[256];
+    int d;
+    int j;
+
+    sprintf(line, "<" EX "s%d> <" EX "list> _:c%dd0 .\n", c, c);
+    bench_append(sb, line);
+    statements++;
+
+    /* ( ( ( ... ) ) ) */
+    for(d = 0; d < BENCH_COLLECTION_DEPTH; d++) {
+      if(d < BENCH_COLLECTION_DEPTH - 1)
+        sprintf(line, "_:c%dd%d <" RDF "first> _:c%dd%d .\n", c, d, c, d + 1);
+      else
+        sprintf(line, "_:c%dd%d <" RDF "first> _:c%di0 .\n", c, d, c);
+      bench_append(sb, line);
+      sprintf(line, "_:c%dd%d <" RDF "rest> <" RDF "nil> .\n", c, d);
+      bench_append(sb, line);
+      statements += 2;
+    }
+
+    /* ( "item 0" "item 1" ... ) */
+    for(j = 0; j < BENCH_COLLECTION_LENGTH; j++) {
+      sprintf(line, "_:c%di%d <" RDF "first> \"item %d\" .\n", c, j, j);
+      bench_append(sb, line);
+      if(j < BENCH_COLLECTION_LENGTH - 1)
+        sprintf(line, "_:c%di%d <" RDF "rest> _:c%di%d .\n", c, j, c, j + 1);
+      else
+        sprintf(line, "_:c%di%d <" RDF "rest> <" RDF "nil> .\n", c, j);
+      bench_append(sb, line);
+      statements += 2;
+    }
+  }
+
+  return statements;
+}
+
+
+typedef struct {
+  const char* name;
+  int (*generate)(raptor_stringbuffer* sb, int count);
+} bench_workload;
+
+static const bench_workload bench_workloads[] = {
+  { "plain", bench_generate_plain },
+  { "long-literals", bench_generate_long_literals },
+  { "bnodes", bench_generate_bnodes },
+  { "collections", bench_generate_collections }
+};
+
+#define BENCH_WORKLOADS_COUNT \
+  (int)(sizeof(bench_workloads) / sizeof(bench_workloads[0]))
+
+
+/*
+ * Benchmark running and reporting
+ */
+
+typedef struct {
+  raptor_world* world;
+  raptor_uri* base_uri;
+  raptor_uri* ex_uri;
+  raptor_uri* rdf_uri;
+
+  /* runs of each benchmark; the fastest is reported */
+  int runs;
+  /* only benchmark this syntax (or NULL) */
+  const char* syntax;
+
+  /* log messages during the current benchmark */
+  int errors;
+  /* benchmarks that could not run */
+  int failures;
+} bench_context;
+
+
+typedef struct {
+  double seconds;
+  double cpu_seconds;
+  long allocations;
+  long peak_rss;
+} bench_result;
+
+
+static void
+bench_log_handler(void *user_data, raptor_log_message *message)
+{
+  bench_context* ctx = (bench_context*)user_data;
+
+  if(message->level >= RAPTOR_LOG_LEVEL_ERROR)
+    ctx->errors++;
+}
+
+
+static void
+bench_count_statement_handler(void *user_data, raptor_statement *statement)
+{
+  int* count_p = (int*)user_data;
+
+  (*count_p)++;
+}
+
+
+static void
+bench_copy_statement_handler(void *user_data, raptor_statement *statement)
+{
+  raptor_sequence* seq = (raptor_sequence*)user_data;
+
+  raptor_sequence_push(seq, raptor_statement_copy(statement));
+}
+
+
+static void
+bench_run_start(bench_result* run)
+{
+  bench_reset_peak_rss();
+  run->allocations = bench_get_allocations();
+  run->cpu_seconds = bench_get_cpu_time();
+  run->seconds = bench_get_time();
+}
+
+
+static void
+bench_run_end(bench_result* run, bench_result* best)
+{
+  run->seconds = bench_get_time() - run->seconds;
+  run->cpu_seconds = bench_get_cpu_time() - run->cpu_seconds;
+  if(run->allocations >= 0)
+    run->allocations = bench_get_allocations() - run->allocations;
+  run->peak_rss = bench_get_peak_rss();
+
+  if(best->seconds < 0 || run->seconds < best->seconds)
+    *best = *run;
+}
+
+
+static void
+bench_print_string(const char* string)
+{
+  putchar('"');
+  for(; *string; string++) {
+    unsigned char c = (unsigned char)*string;
+
+    if(c == '"' || c == '\\')
+      printf("\\%c", c);
+    else if(c < 0x20)
+      printf("\\u%04x", c);
+    else
+      putchar(c);
+  }
+  putchar('"');
+}
+
+
+static void
+bench_report(bench_context* ctx, const char* benchmark,
+             const char* workload, const char* syntax,
+             int statements, size_t bytes, bench_result* best)
+{
+  double seconds = best->seconds > 0 ? best->seconds : 1e-9;
+
+  fputs("{\"benchmark\":", stdout);
+  bench_print_string(benchmark);
+  fputs(",\"workload\":", stdout);
+  bench_print_string(workload);
+  fputs(",\"syntax\":", stdout);
+  bench_print_string(syntax);
+  printf(",\"statements\":%d,\"bytes\":%lu,\"runs\":%d"
+         ",\"seconds\":%.6f,\"cpu_seconds\":%.6f"
+         ",\"statements_per_sec\":%.1f,\"mb_per_sec\":%.3f"
+         ",\"allocations\":%ld,\"peak_rss_kb\":%ld,\"errors\":%d}\n",
+         statements, (unsigned long)bytes, ctx->runs,
+         best->seconds, best->cpu_seconds,
+         statements / seconds, (double)bytes / 1e6 / seconds,
+         best->allocations, best->peak_rss, ctx->errors);
+  fflush(stdout);
+}
+
+
+/*
+ * bench_parse:
+ * @ctx: context
+ * @workload: workload name
+ * @syntax: parser name
+ * @doc: document
+ * @len: length of @doc
+ *
+ * Benchmark parsing @doc.
+ *
+ * Return value: statements parsed or <0 on failure
+ */
+static int
+bench_parse(bench_context* ctx, const char* workload, const char* syntax,
+            const unsigned char* doc, size_t len)
+{
+  raptor_parser* parser;
+  bench_result best;
+  int count = 0;
+  int r;
+
+  parser = raptor_new_parser(ctx->world, syntax);
+  if(!parser) {
+    fprintf(stderr, "raptor_bench: failed to create %s parser\n", syntax);
+    ctx->failures++;
+    return -1;
+  }
+  raptor_parser_set_statement_handler(parser, &count,
+                                      bench_count_statement_handler);
+
+  best.seconds = -1;
+  ctx->errors = 0;
+  for(r = 0; r < ctx->runs; r++) {
+    bench_result run;
+
+    count = 0;
+    bench_run_start(&run);
+    if(!raptor_parser_parse_start(parser, ctx->base_uri))
+      raptor_parser_parse_chunk(parser, doc, len, 1);
+    bench_run_end(&run, &best);
+  }
+
+  bench_report(ctx, "parse", workload, syntax, count, len, &best);
+
+  raptor_free_parser(parser);
+
+  return count;
+}
+
+
+/*
+ * bench_serialize:
+ * @ctx: context
+ * @workload: workload name
+ * @syntax: serializer name
+ * @statements: statements to serialize
+ * @string_p: pointer to store the serialized document
+ * @length_p: pointer to store the length of the document
+ *
+ * Benchmark serializing @statements.
+ *
+ * Return value: non-0 on failure
+ */
+static int
+bench_serialize(bench_context* ctx, const char* workload, const char* syntax,
+                raptor_sequence* statements,
+                unsigned char** string_p, size_t* length_p)
+{
+  int size = raptor_sequence_size(statements);
+  bench_result best;
+  int r;
+
+  *string_p = NULL;
+  *length_p = 0;
+
+  best.seconds = -1;
+  ctx->errors = 0;
+  for(r = 0; r < ctx->runs; r++) {
+    raptor_serializer* serializer;
+    bench_result run;
+    void* string = NULL;
+    size_t length = 0;
+    int i;
+
+    serializer = raptor_new_serializer(ctx->world, syntax);
+    if(!serializer) {
+      fprintf(stderr, "raptor_bench: failed to create %s serializer\n",
+              syntax);
+      ctx->failures++;
+      return 1;
+    }
+    raptor_serializer_set_namespace(serializer, ctx->ex_uri,
+                                    (const unsigned char*)"ex");
+    raptor_serializer_set_namespace(serializer, ctx->rdf_uri,
+                                    (const unsigned char*)"rdf");
+
+    bench_run_start(&run);
+    raptor_serializer_start_to_string(serializer, ctx->base_uri,
+                                      &string, &length);
+    for(i = 0; i < size; i++)
+      raptor_serializer_serialize_statement(serializer,
+                      (raptor_statement*)raptor_sequence_get_at(statements, i));
+    raptor_serializer_serialize_end(serializer);
+    raptor_free_serializer(serializer);
+    bench_run_end(&run, &best);
+
+    if(*string_p)
+      raptor_free_memory(*string_p);
+    *string_p = (unsigned char*)string;
+    *length_p = length;
+  }
+
+  bench_report(ctx, "serialize", workload, syntax, size, *length_p, &best);
+
+  return 0;
+}
+
+
+/*
+ * bench_workload_run:
+ * @ctx: context
+ * @workload: workload name
+ * @syntax: parser name for @doc
+ * @doc: workload document
+ * @len: length of @doc
+ *
+ * Run all the benchmarks for a workload
+ */
+static void
+bench_workload_run(bench_context* ctx, const char* workload,
+                   const char* syntax,
+                   const unsigned char* doc, size_t len)
+{
+  raptor_sequence* statements;
+  raptor_parser* parser;
+  unsigned int i;
+
+  if(!ctx->syntax || !strcmp(ctx->syntax, syntax))
+    bench_parse(ctx, workload, syntax, doc, len);
+
+  /* the statements to serialize, read outside any benchmark */
+  statements = raptor_new_sequence((raptor_data_free_handler)raptor_free_statement,
+                                   (raptor_data_print_handler)raptor_statement_print);
+  parser = raptor_new_parser(ctx->world, syntax);
+  if(!statements || !parser) {
+    fprintf(stderr, "raptor_bench: failed to read workload %s\n", workload);
+    ctx->failures++;
+    goto tidy;
+  }
+  raptor_parser_set_statement_handler(parser, statements,
+                                      bench_copy_statement_handler);
+  if(!raptor_parser_parse_start(parser, ctx->base_uri))
+    raptor_parser_parse_chunk(parser, doc, len, 1);
+
+  for(i = 0; 1; i++) {
+    const raptor_syntax_description* desc;
+    const char* name;
+    unsigned char* string = NULL;
+    size_t length = 0;
+
+    desc = raptor_world_get_serializer_description(ctx->world, i);
+    if(!desc)
+      break;
+    name = desc->names[0];
+
+    if(ctx->syntax && strcmp(ctx->syntax, name))
+      continue;
+
+    if(bench_serialize(ctx, workload, name, statements, &string, &length))
+      continue;
+
+    /* parse the output too, if there is a parser for it */
+    if(string && strcmp(name, syntax) &&
+       raptor_world_is_parser_name(ctx->world, name))
+      bench_parse(ctx, workload, name, string, length);
+
+    if(string)
+      raptor_free_memory(string);
+  }
+
+  tidy:
+  if(parser)
+    raptor_free_parser(parser);
+  if(statements)
+    raptor_free_sequence(statements);
+}
+
+
+/* read a file into memory; returns NULL on failure */
+static unsigned char*
+bench_read_file(const char* filename, size_t* len_p)
+{
+  FILE* fh;
+  unsigned char* buffer = NULL;
+  size_t size = 0;
+  size_t len = 0;
+
+  fh = fopen(filename, "rb");
+  if(!fh)
+    return NULL;
+
+  while(1) {
+    size_t n;
+
+    if(len == size) {
+      unsigned char* new_buffer;
+
+      size = size ? size * 2 : 65536;
+      new_buffer = (unsigned char*)realloc(buffer, size + 1);
+      if(!new_buffer) {
+        free(buffer);
+        fclose(fh);
+        return NULL;
+      }
+      buffer = new_buffer;
+    }
+
+    n = fread(buffer + len, 1, size - len, fh);
+    if(!n)
+      break;
+    len += n;
+  }
+  fclose(fh);
+
+  buffer[len] = '\0';
+  *len_p = len;
+
+  return buffer;
+}
+
+
+static void
+bench_usage(const char* program, FILE* fh)
+{
+  fprintf(fh,
+          "Usage: %s [OPTIONS] [FILE...]\n"
+          "Benchmark Raptor parsers and serializers, writing one JSON object\n"
+          "per benchmark to standard output.\n"
+          "\n"
+          "With FILEs, benchmark parsing each FILE and serializing its\n"
+          "statements, otherwise use the synthetic workloads.\n"
+          "\n"
+          "  -n COUNT   Statements per synthetic workload (default 100000)\n"
+          "  -r RUNS    Runs of each benchmark; the fastest is reported (default 3)\n"
+          "  -s SYNTAX  Only benchmark the parser and serializer SYNTAX\n"
+          "  -w NAME    Only run the synthetic workload NAME:",
+          program);
+  {
+    int w;
+    for(w = 0; w < BENCH_WORKLOADS_COUNT; w++)
+      fprintf(fh, " %s", bench_workloads[w].name);
+  }
+  fputs("\n  -h         Show this help\n", fh);
+}
+
+
+int main(int argc, char *argv[]);
+
+int
+main(int argc, char *argv[])
+{
+  const char* program = "raptor_bench";
+  bench_context ctx;
+  const char* workload_name = NULL;
+  int count = 100000;
+  int i;
+
+  memset(&ctx, '\0', sizeof(ctx));
+  ctx.runs = 3;
+
+  for(i = 1; i < argc && argv[i][0] == '-'; i++) {
+    const char* arg = argv[i];
+
+    if(!strcmp(arg, "-h")) {
+      bench_usage(program, stdout);
+      return 0;
+    }
+
+    if(!arg[1] || arg[2] || !strchr("nrsw", arg[1]) || i + 1 == argc) {
+      bench_usage(program, stderr);
+      return 1;
+    }
+
+    switch(arg[1]) {
+      case 'n':
+        count = atoi(argv[++i]);
+        break;
+      case 'r':
+        ctx.runs = atoi(argv[++i]);
+        break;
+      case 's':
+        ctx.syntax = argv[++i];
+        break;
+      default:
+        workload_name = argv[++i];
+        break;
+    }
+  }
+  if(count < 1 || ctx.runs < 1) {
+    bench_usage(program, stderr);
+    return 1;
+  }
+
+  ctx.world = raptor_new_world();
+  if(!ctx.world || raptor_world_open(ctx.world))
+    return 1;
+  raptor_world_set_log_handler(ctx.world, &ctx, bench_log_handler);
+
+  ctx.base_uri = raptor_new_uri(ctx.world,
+                                (const unsigned char*)EX "base/");
+  ctx.ex_uri = raptor_new_uri(ctx.world, (const unsigned char*)EX);
+  ctx.rdf_uri = raptor_new_uri(ctx.world, (const unsigned char*)RDF);
+  if(!ctx.base_uri || !ctx.ex_uri || !ctx.rdf_uri)
+    return 1;
+
+  if(i < argc) {
+    /* corpus workloads */
+    for(; i < argc; i++) {
+      const char* filename = argv[i];
+      const char* syntax;
+      unsigned char* doc;
+      size_t len = 0;
+      const char* name;
+
+      doc = bench_read_file(filename, &len);
+      if(!doc) {
+        fprintf(stderr, "%s: cannot read %s\n", program, filename);
+        ctx.failures++;
+        continue;
+      }
+
+      syntax = raptor_world_guess_parser_name(ctx.world, NULL, NULL,
+                                              doc, len,
+                                              (const unsigned char*)filename);
+      if(!syntax) {
+        fprintf(stderr, "%s: cannot guess the syntax of %s\n", program,
+                filename);
+        ctx.failures++;
+      } else {
+        name = strrchr(filename, '/');
+        name = name ? name + 1 : filename;
+        bench_workload_run(&ctx, name, syntax, doc, len);
+      }
+
+      free(doc);
+    }
+  } else {
+    /* synthetic workloads */
+    int w;
+
+    for(w = 0; w < BENCH_WORKLOADS_COUNT; w++) {
+      const bench_workload* workload = &bench_workloads[w];
+      raptor_stringbuffer* sb;
+
+      if(workload_name && strcmp(workload_name, workload->name))
+        continue;
+
+      sb = raptor_new_stringbuffer();
+      if(!sb)
+        return 1;
+      workload->generate(sb, count);
+
+      bench_workload_run(&ctx, workload->name, "ntriples",
+                         raptor_stringbuffer_as_string(sb),
+                         raptor_stringbuffer_length(sb));
+
+      raptor_free_stringbuffer(sb);
+    }
+  }
+
+  raptor_free_uri(ctx.rdf_uri);
+  raptor_free_uri(ctx.ex_uri);
+  raptor_free_uri(ctx.base_uri);
+  raptor_free_world(ctx.world);
+
+  return ctx.failures ? 1 : 0;
+}